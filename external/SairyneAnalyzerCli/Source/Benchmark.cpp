@@ -0,0 +1,495 @@
+#include "Benchmark.h"
+#include <iostream>
+#include "../../SairynePlugin/Source/PluginProcessor.h"
+#include "../../SairynePlugin/Source/RealtimeContext.h"
+#include "../../SairynePlugin/Source/SairyneBridgeCodec.h"
+#include "../../SairynePlugin/Source/SairyneDiagnostics.h"
+#include "../../SairynePlugin/Source/SairyneServices.h"
+#include "../../SairynePlugin/Source/SairyneSessionState.h"
+#include "../../SairynePlugin/Source/SairyneStore.h"
+#include "../../SairynePlugin/Source/SairyneUiBundle.h"
+
+namespace
+{
+	constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+	constexpr int blockSizes[] = { 64, 128, 256, 512, 1024 };
+	constexpr int numChannels = 2;
+
+	// Faster than real time, but paced so the analysis thread keeps roughly the duty cycle
+	// it has in a host instead of racing a tight loop
+	constexpr double paceFactor = 16.0;
+
+	juce::String column (const juce::String& text, int width)
+	{
+		return text.paddedRight (' ', width);
+	}
+
+	juce::String formatMicros (double micros)
+	{
+		return micros >= 1000.0 ? juce::String (micros / 1000.0, 2) + " ms" : juce::String (micros, 1) + " us";
+	}
+
+	double megabytesPerSecond (double numBytes, juce::int64 ticks)
+	{
+		return numBytes / (1024.0 * 1024.0) / juce::jmax (1.0e-9, juce::Time::highResolutionTicksToSeconds (ticks));
+	}
+
+	// Looks like the chat state the UI stores: JSON with quotes, newlines and non-ASCII text,
+	// so both codecs go through their escape paths
+	juce::String makeChatState (size_t numBytes)
+	{
+		const juce::String message (juce::CharPointer_UTF8 ("{\"role\":\"assistant\",\"text\":\"Cut 3 dB around 250 Hz on the \\\"Bass\\\" bus\\n"
+		                                                    "then check the vocal \xe2\x80\x94 \xc2\xab" "presence\xc2\xbb at 4 kHz\"},"));
+		juce::MemoryOutputStream out;
+		out << "[";
+
+		while (out.getDataSize() < numBytes)
+			out << message;
+
+		out << "]";
+		return out.toUTF8();
+	}
+
+	//==============================================================================
+	juce::var benchProcessBlock (double secondsPerConfig)
+	{
+		std::cout << "processBlock: " << numChannels << " channels, " << juce::String (secondsPerConfig, 1)
+		          << " s of audio per config, editor open (full-rate spectrum)\n"
+		          << column ("rate", 8) << column ("block", 7) << column ("budget", 11) << column ("mean", 11) << column ("p99", 11)
+		          << column ("max", 11) << column ("p99 load", 10) << column ("analysis", 10) << "dropped\n";
+
+		// The processor records into the process-wide services' diagnostics; holding them here
+		// keeps one instance (and its analysis thread) alive across configs
+		juce::SharedResourcePointer<SairyneServices> services;
+		auto& diagnostics = services->getDiagnostics();
+		juce::Random random (1);
+		juce::MidiBuffer midi;
+		juce::Array<juce::var> results;
+
+		for (const auto sampleRate : sampleRates)
+		{
+			for (const auto blockSize : blockSizes)
+			{
+				// Prepared the way a host does it, with an editor open
+				SairyneAudioProcessor processor;
+				processor.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+				processor.prepareToPlay (sampleRate, blockSize);
+				processor.editorAttached();
+
+				juce::AudioBuffer<float> buffer (numChannels, blockSize);
+				for (int ch = 0; ch < numChannels; ++ch)
+					for (int i = 0; i < blockSize; ++i)
+						buffer.setSample (ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+				diagnostics.reset();
+
+				const int numBlocks = juce::jmax (1, (int) (secondsPerConfig * sampleRate / blockSize));
+				const double blockMs = 1000.0 * blockSize / sampleRate;
+				const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+				for (int block = 0; block < numBlocks; ++block)
+				{
+					// Realtime scope and timing are processBlock's own
+					processor.processBlock (buffer, midi);
+
+					const double aheadMs = startMs + (block + 1) * blockMs / paceFactor - juce::Time::getMillisecondCounterHiRes();
+					if (aheadMs >= 1.0)
+						juce::Thread::sleep ((int) aheadMs);
+				}
+
+				// Let the analysis thread drain what is still queued before reading its counters
+				juce::Thread::sleep (100);
+				processor.editorDetached();
+				processor.releaseResources();
+
+				const auto block = diagnostics.processBlockMicros.getSummary();
+				const auto load = diagnostics.processBlockLoad.getSummary();
+				const auto analysis = diagnostics.analysisPassMicros.getSummary();
+				const double audioSeconds = (double) numBlocks * blockSize / sampleRate;
+				const double analysisLoad = analysis.mean * (double) analysis.count / (audioSeconds * 1.0e6);
+				const auto dropped = processor.getAnalysisEngine().getDroppedSampleCount();
+
+				std::cout << column (juce::String (sampleRate / 1000.0, 1) + "k", 8)
+				          << column (juce::String (blockSize), 7)
+				          << column (formatMicros (1.0e6 * blockSize / sampleRate), 11)
+				          << column (formatMicros (block.mean), 11)
+				          << column (formatMicros (block.p99), 11)
+				          << column (formatMicros (block.max), 11)
+				          << column (juce::String (load.p99 / 10.0, 2) + "%", 10)
+				          << column (juce::String (100.0 * analysisLoad, 2) + "%", 10)
+				          << (juce::int64) dropped << "\n";
+
+				auto* obj = new juce::DynamicObject();
+				obj->setProperty("sampleRate", sampleRate);
+				obj->setProperty("blockSize", blockSize);
+				obj->setProperty("blocks", numBlocks);
+				obj->setProperty("diagnostics", diagnostics.toVar());
+				obj->setProperty("analysisThreadLoad", analysisLoad);
+				obj->setProperty("droppedSamples", (juce::int64) dropped);
+				results.add (juce::var (obj));
+			}
+		}
+
+		return results;
+	}
+
+	//==============================================================================
+	juce::var benchStorage()
+	{
+		struct Case { const char* name; size_t numBytes; int numOps; };
+		const Case cases[] = { { "256 B", 256, 5000 }, { "16 KB", 16 * 1024, 1000 }, { "1 MB", 1024 * 1024, 40 } };
+
+		// A scratch store, never the user's
+		const auto directory = juce::File::getSpecialLocation (juce::File::tempDirectory)
+		                           .getNonexistentChildFile ("SairyneBench", {}, false);
+		directory.createDirectory();
+
+		std::cout << "\nStore (scratch store in " << directory.getFullPathName() << ")\n"
+		          << column ("value", 8) << column ("set p50", 11) << column ("set p99", 11) << column ("set MB/s", 10)
+		          << column ("get p50", 11) << "get p99\n";
+
+		auto* obj = new juce::DynamicObject();
+		juce::Array<juce::var> caseResults;
+
+		{
+			SairyneStore store (directory);
+
+			for (const auto& c : cases)
+			{
+				// Alternate two values over an odd number of keys so every set is a real change
+				const auto valueA = makeChatState (c.numBytes);
+				const auto valueB = valueA.replaceFirstOccurrenceOf ("assistant", "assistent");
+				constexpr int numKeys = 15;
+
+				juce::StringArray keys;
+				for (int k = 0; k < numKeys; ++k)
+					keys.add ("bench_" + juce::String (c.name).removeCharacters (" ") + "_" + juce::String (k));
+
+				SairyneHistogram setMicros, getMicros;
+				juce::int64 setTicks = 0;
+
+				for (int i = 0; i < c.numOps; ++i)
+				{
+					const auto startTicks = juce::Time::getHighResolutionTicks();
+					store.setValue (keys[i % numKeys], (i & 1) != 0 ? valueB : valueA);
+					const auto elapsed = juce::Time::getHighResolutionTicks() - startTicks;
+					setTicks += elapsed;
+					setMicros.record (SairyneDiagnostics::ticksToMicros (elapsed));
+				}
+
+				for (int i = 0; i < c.numOps; ++i)
+				{
+					const auto startTicks = juce::Time::getHighResolutionTicks();
+					const auto value = store.getValue (keys[i % numKeys]);
+					getMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+					jassert (value.isNotEmpty());
+					juce::ignoreUnused (value);
+				}
+
+				const auto set = setMicros.getSummary();
+				const auto get = getMicros.getSummary();
+				const double setMBps = megabytesPerSecond ((double) valueA.getNumBytesAsUTF8() * c.numOps, setTicks);
+
+				std::cout << column (c.name, 8)
+				          << column (formatMicros (set.p50), 11) << column (formatMicros (set.p99), 11)
+				          << column (juce::String (setMBps, 0), 10)
+				          << column (formatMicros (get.p50), 11) << formatMicros (get.p99) << "\n";
+
+				auto* caseObj = new juce::DynamicObject();
+				caseObj->setProperty("value", c.name);
+				caseObj->setProperty("operations", c.numOps);
+				caseObj->setProperty("setMicros", setMicros.toVar());
+				caseObj->setProperty("getMicros", getMicros.toVar());
+				caseObj->setProperty("setMegabytesPerSecond", setMBps);
+				caseResults.add (juce::var (caseObj));
+			}
+
+			// Give the write-behind thread time to flush the last batch
+			juce::Thread::sleep (750);
+
+			const auto& stats = store.getStats();
+			const auto flush = stats.flushMicros.getSummary();
+			const auto written = stats.bytesWritten.load();
+			const double flushSeconds = flush.mean * (double) flush.count / 1.0e6;
+
+			std::cout << "writer: " << (juce::int64) stats.batchesWritten.load() << " batches, "
+			          << (juce::int64) stats.recordsWritten.load() << " records, "
+			          << juce::String ((double) written / (1024.0 * 1024.0), 1) << " MB written, flush p50 "
+			          << formatMicros (flush.p50) << " / p99 " << formatMicros (flush.p99) << ", "
+			          << (juce::int64) stats.compactions.load() << " compactions\n";
+
+			obj->setProperty("values", caseResults);
+			obj->setProperty("flushMicros", stats.flushMicros.toVar());
+			obj->setProperty("compactionMicros", stats.compactionMicros.toVar());
+			obj->setProperty("bytesWritten", (juce::int64) written);
+			obj->setProperty("writerMegabytesPerSecond", flushSeconds > 0.0 ? (double) written / (1024.0 * 1024.0) / flushSeconds : 0.0);
+		}
+
+		directory.deleteRecursively();
+
+		// Host session chunk: a changed 1 MB chat state saved, then a project reopened
+		{
+			const auto chatState = makeChatState (1024 * 1024);
+			constexpr int numRuns = 20;
+			SairyneHistogram saveMicros, cleanSaveMicros, restoreMicros;
+			juce::MemoryBlock chunk;
+
+			SairyneSessionState state;
+
+			for (int i = 0; i < numRuns; ++i)
+			{
+				state.setValue ("chatState", (i & 1) != 0 ? chatState : chatState + " ");
+
+				auto startTicks = juce::Time::getHighResolutionTicks();
+				state.writeTo (chunk);
+				saveMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+
+				startTicks = juce::Time::getHighResolutionTicks();
+				state.writeTo (chunk);
+				cleanSaveMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+
+				SairyneSessionState restored;
+				startTicks = juce::Time::getHighResolutionTicks();
+				restored.restoreFrom (chunk.getData(), (int) chunk.getSize());
+				const auto value = restored.getValue ("chatState");
+				restoreMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+				jassert (value.getNumBytesAsUTF8() >= chatState.getNumBytesAsUTF8());
+				juce::ignoreUnused (value);
+			}
+
+			std::cout << "\nSession state (1 MB chat state, " << juce::String ((double) chunk.getSize() / 1024.0, 0) << " KB chunk): save "
+			          << formatMicros (saveMicros.getSummary().p50) << ", unchanged save "
+			          << formatMicros (cleanSaveMicros.getSummary().p50) << ", restore + read "
+			          << formatMicros (restoreMicros.getSummary().p50) << " (p50)\n";
+
+			auto* sessionObj = new juce::DynamicObject();
+			sessionObj->setProperty("rawBytes", (juce::int64) chatState.getNumBytesAsUTF8());
+			sessionObj->setProperty("chunkBytes", (juce::int64) chunk.getSize());
+			sessionObj->setProperty("saveMicros", saveMicros.toVar());
+			sessionObj->setProperty("unchangedSaveMicros", cleanSaveMicros.toVar());
+			sessionObj->setProperty("restoreMicros", restoreMicros.toVar());
+			obj->setProperty("sessionState", juce::var (sessionObj));
+		}
+
+		return juce::var (obj);
+	}
+
+	//==============================================================================
+	// Vite links its output as "/assets/..." or "./assets/..."
+	juce::StringArray getLinkedAssets (const juce::String& html)
+	{
+		juce::StringArray paths;
+
+		for (int start = html.indexOf ("assets/"); start >= 0; start = html.indexOf (start + 1, "assets/"))
+			if (const int end = html.indexOfAnyOf ("\"' >", start); end > start)
+				paths.addIfNotAlreadyThere (html.substring (start, end));
+
+		return paths;
+	}
+
+	// Serves the entry page and the assets it links, as the WebView asks for them on open.
+	// Returns the bytes served, or -1 if the bundle has no entry page.
+	juce::int64 serveEntryPage (SairyneUiBundle& bundle, int& numFiles)
+	{
+		const auto page = bundle.getResource (juce::String ("/") + SairyneUiBundle::entryPage);
+		if (! page.has_value())
+			return -1;
+
+		auto numBytes = (juce::int64) page->data.size();
+		numFiles = 1;
+
+		const auto html = juce::String::fromUTF8 (reinterpret_cast<const char*> (page->data.data()), (int) page->data.size());
+
+		for (const auto& path : getLinkedAssets (html))
+		{
+			if (const auto asset = bundle.getResource ("/" + path))
+			{
+				numBytes += (juce::int64) asset->data.size();
+				++numFiles;
+			}
+		}
+
+		return numBytes;
+	}
+
+	// The native side of opening the editor: the embedded UI served cold (zip directory read,
+	// every file inflated) and warm (the cache a later editor finds), and the initial state
+	// the page's ready call reads from a reopened project. The page load itself needs a
+	// WebView; the plugin records that live (editorOpenCold/WarmMicros, diagnostics event).
+	juce::var benchEditorOpen()
+	{
+		constexpr int numRuns = 10;
+		std::cout << "\nEditor open, native side (" << numRuns << " runs, p50)\n";
+
+		auto* obj = new juce::DynamicObject();
+
+		{
+			SairyneHistogram coldMicros, warmMicros;
+			juce::int64 numBytes = 0;
+			int numFiles = 0;
+
+			for (int i = 0; i < numRuns && numBytes >= 0; ++i)
+			{
+				auto startTicks = juce::Time::getHighResolutionTicks();
+				SairyneUiBundle bundle;
+				numBytes = serveEntryPage (bundle, numFiles);
+				coldMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+
+				startTicks = juce::Time::getHighResolutionTicks();
+				serveEntryPage (bundle, numFiles);
+				warmMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+			}
+
+			auto* bundleObj = new juce::DynamicObject();
+			bundleObj->setProperty("available", numBytes >= 0);
+
+			if (numBytes < 0)
+			{
+				std::cout << "UI bundle: unavailable (not embedded in this build)\n";
+			}
+			else
+			{
+				std::cout << "UI bundle (" << numFiles << " files, " << juce::String ((double) numBytes / 1024.0, 0) << " KB): cold "
+				          << formatMicros (coldMicros.getSummary().p50) << ", warm " << formatMicros (warmMicros.getSummary().p50) << "\n";
+
+				bundleObj->setProperty("files", numFiles);
+				bundleObj->setProperty("bytes", numBytes);
+				bundleObj->setProperty("coldMicros", coldMicros.toVar());
+				bundleObj->setProperty("warmMicros", warmMicros.toVar());
+			}
+
+			obj->setProperty("uiBundle", juce::var (bundleObj));
+		}
+
+		{
+			// A project saved with a 1 MB chat state, reopened: restore, then every session
+			// value read and JSON-encoded the way the ready call returns them
+			juce::MemoryBlock chunk;
+			{
+				SairyneSessionState saved;
+				saved.setValue ("sairyne_functional_chat_state_v1", makeChatState (1024 * 1024));
+				saved.setValue ("sairyne_selected_project", "Bench");
+				saved.writeTo (chunk);
+			}
+
+			SairyneAudioProcessor processor;
+			SairyneHistogram stateMicros;
+			size_t stateBytes = 0;
+
+			for (int i = 0; i < numRuns; ++i)
+			{
+				const auto startTicks = juce::Time::getHighResolutionTicks();
+				processor.setStateInformation (chunk.getData(), (int) chunk.getSize());
+
+				juce::MemoryOutputStream out;
+				for (const auto& key : processor.getUiSessionKeys())
+					SairyneBridgeCodec::writeJsonString (out, processor.loadUiValue (key));
+
+				stateMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+				stateBytes = out.getDataSize();
+			}
+
+			std::cout << "Initial state (1 MB chat state, restore + read + encode): "
+			          << formatMicros (stateMicros.getSummary().p50) << "\n";
+
+			auto* stateObj = new juce::DynamicObject();
+			stateObj->setProperty("bytes", (juce::int64) stateBytes);
+			stateObj->setProperty("micros", stateMicros.toVar());
+			obj->setProperty("initialState", juce::var (stateObj));
+		}
+
+		return juce::var (obj);
+	}
+
+	//==============================================================================
+	juce::var benchCodecs (bool& ok)
+	{
+		std::cout << "\nBridge codecs\n" << column ("value", 8) << column ("percentDecode", 16) << "writeJsonString\n";
+
+		juce::Array<juce::var> results;
+
+		for (const size_t numBytes : { (size_t) 64 * 1024, (size_t) 1024 * 1024, (size_t) 8 * 1024 * 1024 })
+		{
+			const auto text = makeChatState (numBytes);
+			// What the page's encodeURIComponent hands to juce://save
+			const auto encoded = juce::URL::addEscapeChars (text, true);
+			const int numRuns = juce::jmax (2, (int) ((64 * 1024 * 1024) / numBytes));
+
+			juce::String decoded;
+			auto startTicks = juce::Time::getHighResolutionTicks();
+			for (int i = 0; i < numRuns; ++i)
+				decoded = SairyneBridgeCodec::percentDecode (encoded.toRawUTF8(), encoded.getNumBytesAsUTF8());
+			const double decodeMBps = megabytesPerSecond ((double) encoded.getNumBytesAsUTF8() * numRuns, juce::Time::getHighResolutionTicks() - startTicks);
+
+			startTicks = juce::Time::getHighResolutionTicks();
+			for (int i = 0; i < numRuns; ++i)
+			{
+				juce::MemoryOutputStream out;
+				SairyneBridgeCodec::writeJsonString (out, text);
+			}
+			const double jsonMBps = megabytesPerSecond ((double) text.getNumBytesAsUTF8() * numRuns, juce::Time::getHighResolutionTicks() - startTicks);
+
+			if (decoded != text)
+			{
+				std::cerr << "percentDecode did not round-trip a " << (juce::int64) numBytes << " byte value\n";
+				ok = false;
+			}
+
+			const auto name = numBytes >= 1024 * 1024 ? juce::String ((juce::int64) (numBytes / (1024 * 1024))) + " MB"
+			                                          : juce::String ((juce::int64) (numBytes / 1024)) + " KB";
+
+			std::cout << column (name, 8) << column (juce::String (decodeMBps, 0) + " MB/s", 16) << juce::String (jsonMBps, 0) << " MB/s\n";
+
+			auto* obj = new juce::DynamicObject();
+			obj->setProperty("bytes", (juce::int64) numBytes);
+			obj->setProperty("percentDecodeMegabytesPerSecond", decodeMBps);
+			obj->setProperty("writeJsonStringMegabytesPerSecond", jsonMBps);
+			results.add (juce::var (obj));
+		}
+
+		return results;
+	}
+}
+
+int runBenchmarks (double secondsPerConfig, const juce::File& jsonFile)
+{
+	// The processor and the services behind it expect JUCE's message manager
+	const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+	bool ok = true;
+
+	auto* obj = new juce::DynamicObject();
+	juce::var report (obj);
+
+	obj->setProperty("processBlock", benchProcessBlock (secondsPerConfig));
+
+   #if SAIRYNE_DETECT_REALTIME_ALLOCATIONS
+	const auto allocations = SairyneRealtimeScope::getAllocationViolationCount();
+	const auto blockingCalls = SairyneRealtimeScope::getBlockingCallViolationCount();
+	std::cout << "Allocations on the audio path: " << allocations << ", locks or logging: " << blockingCalls << "\n";
+	obj->setProperty("realtimeAllocations", allocations);
+	obj->setProperty("realtimeBlockingCalls", blockingCalls);
+	ok = allocations == 0 && blockingCalls == 0;
+   #else
+	std::cout << "Allocations on the audio path: not checked (build with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1)\n";
+   #endif
+
+	obj->setProperty("storage", benchStorage());
+	obj->setProperty("codecs", benchCodecs (ok));
+	obj->setProperty("editorOpen", benchEditorOpen());
+
+	// These need a host and a WebView; the plugin reports them in its "diagnostics" event
+	std::cout << "\nThe WebView page load and analysis frame round trip are measured live by the plugin (diagnostics event).\n";
+
+	if (jsonFile != juce::File())
+	{
+		if (! jsonFile.replaceWithText (juce::JSON::toString (report)))
+		{
+			std::cerr << "Could not write " << jsonFile.getFullPathName() << "\n";
+			return 1;
+		}
+
+		std::cout << "Report written to " << jsonFile.getFullPathName() << "\n";
+	}
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <JuceHeader.h>
+
+// --bench: headless performance checks for the plugin's hot paths (SairyneAudioProcessor::
+// processBlock cost per block against its real-time budget, analysis thread load, store and
+// session state latency/throughput, bridge codec throughput, the native side of opening the
+// editor: UI bundle served cold/warm and the page's initial state). Prints a table per section;
+// with a JSON file, also writes every number there so runs can be compared across builds.
+// Returns non-zero if the audio path allocated, locked or logged (only detectable in builds
+// with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1).
+int runBenchmarks (double secondsPerConfig, const juce::File& jsonFile);
@@ -0,0 +1,193 @@
+/*
+    Headless stem analyzer.
+
+    Same engine as the plugin's "Analyzing your channels..." flow (StemAnalyzer), built as a
+    console app from the plugin's sources (target SairyneAnalyzerCli in external/CMakeLists.txt):
+
+        cmake -S external -B build -DSAIRYNE_JUCE_DIR=/path/to/JUCE
+        cmake --build build --target SairyneAnalyzerCli
+
+    Usage:
+        SairyneAnalyzerCli [--threads N] [--segment SECONDS] [--json OUT.json] [--scaling] <files or folders...>
+        SairyneAnalyzerCli --bench [SECONDS] [--json OUT.json]
+
+    --scaling runs the whole set once per thread count (1, 2, 4, ... all cores) and prints
+    the speed-up, so per-core scaling can be checked on a given machine and stem set.
+
+    --bench needs no input files: it runs the plugin's processor and measures processBlock's
+    cost per block (SECONDS of audio per sample rate / block size, default 5), the analysis
+    thread, the store, session state, bridge codecs and the native side of opening the editor
+    (see Benchmark.h). Exits non-zero if
+    the audio path allocated, locked or logged, in builds with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1.
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "Benchmark.h"
+#include "../../SairynePlugin/Source/StemAnalyzer.h"
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "Usage: SairyneAnalyzerCli [--threads N] [--segment SECONDS] [--json OUT.json] [--scaling] <files or folders...>\n"
+		          << "       SairyneAnalyzerCli --bench [SECONDS] [--json OUT.json]\n";
+	}
+
+	juce::String pad (const juce::String& text, int width)
+	{
+		return text.length() >= width ? text.substring (0, width - 1) + " " : text.paddedRight (' ', width);
+	}
+
+	void printReport (const StemAnalyzer::Report& report)
+	{
+		std::cout << pad ("stem", 32) << pad ("length", 10) << pad ("LUFS", 9) << pad ("peak", 9) << pad ("rms", 9) << "mmap\n";
+
+		for (const auto& stem : report.stems)
+		{
+			if (stem.error.isNotEmpty())
+			{
+				std::cout << pad (stem.name, 32) << "error: " << stem.error << "\n";
+				continue;
+			}
+
+			std::cout << pad (stem.name, 32)
+			          << pad (juce::String (stem.lengthSeconds, 1) + " s", 10)
+			          << pad (juce::String (stem.integratedLufs, 1), 9)
+			          << pad (juce::String (stem.peakDb, 1), 9)
+			          << pad (juce::String (stem.rmsDb, 1), 9)
+			          << (stem.memoryMapped ? "yes" : "no") << "\n";
+		}
+
+		if (! report.masking.empty())
+		{
+			std::cout << "\nStrongest masking:\n";
+
+			for (size_t i = 0; i < report.masking.size() && i < 10; ++i)
+			{
+				const auto& pair = report.masking[i];
+				juce::String bands;
+				for (size_t b = 0; b < pair.bands.size() && b < 3; ++b)
+					bands << (b > 0 ? ", " : "") << juce::String (SpectralBands::getCentreHz (pair.bands[b].first), 0) << " Hz";
+
+				std::cout << "  " << report.stems[(size_t) pair.stemA].name << " <-> " << report.stems[(size_t) pair.stemB].name
+				          << "  score " << juce::String (pair.score, 2) << "  (" << bands << ")\n";
+			}
+		}
+	}
+
+	void printTiming (const StemAnalyzer::Report& report)
+	{
+		std::cout << "\n" << report.stems.size() << " stems, " << juce::String (report.audioSeconds, 1) << " s of audio in "
+		          << juce::String (report.wallSeconds, 3) << " s (" << juce::String (report.audioSeconds / juce::jmax (1.0e-9, report.wallSeconds), 0)
+		          << "x realtime) on " << report.numThreads << " threads, " << report.numSegments << " segments, "
+		          << (juce::int64) report.stolenJobs << " stolen\n";
+	}
+}
+
+int main (int argc, char* argv[])
+{
+	StemAnalyzer::Options options;
+	juce::File jsonFile;
+	bool scaling = false;
+	bool bench = false;
+	double benchSeconds = 5.0;
+	juce::Array<juce::File> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const juce::String arg (juce::CharPointer_UTF8 (argv[i]));
+		const bool hasValue = i + 1 < argc;
+
+		if (arg == "--threads" && hasValue)
+			options.numThreads = juce::String (argv[++i]).getIntValue();
+		else if (arg == "--segment" && hasValue)
+			options.segmentSeconds = juce::jmax (1.0, juce::String (argv[++i]).getDoubleValue());
+		else if (arg == "--json" && hasValue)
+			jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile (juce::String (juce::CharPointer_UTF8 (argv[++i])));
+		else if (arg == "--scaling")
+			scaling = true;
+		else if (arg == "--bench")
+		{
+			bench = true;
+
+			if (hasValue && juce::String (argv[i + 1]).containsOnly ("0123456789."))
+				benchSeconds = juce::jmax (0.1, juce::String (argv[++i]).getDoubleValue());
+		}
+		else if (arg == "--help" || arg == "-h")
+		{
+			printUsage();
+			return 0;
+		}
+		else
+		{
+			const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (arg);
+
+			if (file.isDirectory())
+				files.addArray (StemAnalyzer::findAudioFiles (file));
+			else if (file.existsAsFile())
+				files.add (file);
+			else
+				std::cerr << "Skipping " << arg << ": not found\n";
+		}
+	}
+
+	if (bench)
+		return runBenchmarks (benchSeconds, jsonFile);
+
+	if (files.isEmpty())
+	{
+		printUsage();
+		return 1;
+	}
+
+	if (scaling)
+	{
+		// Warm the page cache first so the 1-thread run isn't also paying for the disk
+		StemAnalyzer (options).analyse (files);
+
+		const int maxThreads = options.numThreads > 0 ? options.numThreads : juce::SystemStats::getNumCpus();
+		double baseline = 0.0;
+
+		std::cout << pad ("threads", 10) << pad ("seconds", 12) << pad ("speed-up", 11) << pad ("efficiency", 12) << "stolen\n";
+
+		for (int threads = 1;; threads = juce::jmin (threads * 2, maxThreads))
+		{
+			auto runOptions = options;
+			runOptions.numThreads = threads;
+			const auto report = StemAnalyzer (runOptions).analyse (files);
+
+			if (threads == 1)
+				baseline = report.wallSeconds;
+
+			const double speedUp = baseline / juce::jmax (1.0e-9, report.wallSeconds);
+			std::cout << pad (juce::String (threads), 10)
+			          << pad (juce::String (report.wallSeconds, 3), 12)
+			          << pad (juce::String (speedUp, 2) + "x", 11)
+			          << pad (juce::String (100.0 * speedUp / threads, 0) + "%", 12)
+			          << (juce::int64) report.stolenJobs << "\n";
+
+			if (threads >= maxThreads)
+				break;
+		}
+
+		return 0;
+	}
+
+	const auto report = StemAnalyzer (options).analyse (files);
+	printReport (report);
+	printTiming (report);
+
+	if (jsonFile != juce::File())
+	{
+		if (! jsonFile.replaceWithText (juce::JSON::toString (report.toVar())))
+		{
+			std::cerr << "Could not write " << jsonFile.getFullPathName() << "\n";
+			return 1;
+		}
+
+		std::cout << "Report written to " << jsonFile.getFullPathName() << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,11 @@
+#include "../Source/PluginProcessor.h"
+
+// Stands in for Source/PluginEntryPoints.cpp in the headless targets (SairyneAnalyzerCli,
+// the tests): the processor runs without its editor, and there is no plugin wrapper to
+// call createPluginFilter().
+
+juce::AudioProcessorEditor* SairyneAudioProcessor::createEditor()
+{
+	jassertfalse; // nothing can show an editor here
+	return nullptr;
+}
@@ -0,0 +1,306 @@
+#include "AnalysisEngine.h"
+#include "RealtimeContext.h"
+#include "SairyneServices.h"
+#include <cmath>
+
+namespace
+{
+	// Four independent accumulators so the compiler can keep the loop in SIMD registers
+	inline double sumOfProducts (const float* a, const float* b, int numSamples) noexcept
+	{
+		float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+		int i = 0;
+
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			acc0 += a[i]     * b[i];
+			acc1 += a[i + 1] * b[i + 1];
+			acc2 += a[i + 2] * b[i + 2];
+			acc3 += a[i + 3] * b[i + 3];
+		}
+
+		for (; i < numSamples; ++i)
+			acc0 += a[i] * b[i];
+
+		return (double) acc0 + (double) acc1 + (double) acc2 + (double) acc3;
+	}
+
+	inline float toDb (double gain) noexcept
+	{
+		return gain > 1.0e-5 ? (float) (20.0 * std::log10 (gain)) : SairyneAnalysisEngine::silenceDb;
+	}
+}
+
+SairyneAnalysisEngine::SairyneAnalysisEngine (SairyneAnalysisScheduler& s, SairyneTrackBus& bus)
+	: scheduler (s), trackBus (bus), trackSlot (bus.claimSlot())
+{
+}
+
+SairyneAnalysisEngine::~SairyneAnalysisEngine()
+{
+	release();
+	trackBus.releaseSlot (trackSlot);
+}
+
+void SairyneAnalysisEngine::prepare (double sampleRate, int maximumBlockSize, int numChannels)
+{
+	SAIRYNE_ASSERT_NOT_REALTIME();
+	release();
+
+	channels = juce::jlimit (1, maxChannels, numChannels);
+
+	// Half a second of audio (or 8 host blocks, whichever is larger) gives the analysis
+	// thread plenty of slack before the audio thread has to start dropping samples.
+	const int wanted = juce::jmax (juce::roundToInt (sampleRate * 0.5), maximumBlockSize * 8, fftSize * 2);
+	const int capacity = juce::nextPowerOfTwo (wanted);
+
+	fifoBuffer.setSize (channels, capacity, false, true, false);
+	fifo.setTotalSize (capacity);
+	fifo.reset();
+	chunkBuffer.setSize (channels, hopSize, false, true, false);
+
+	loudness.prepare (sampleRate, channels);
+	fftHistory.fill (0.0f);
+	fftHistoryWrite = 0;
+	samplesSinceLastFft = 0;
+	hopsSinceSpectrum = 0;
+	currentSampleRate = sampleRate;
+
+	for (int bin = 0; bin < numSpectrumBins; ++bin)
+		binToBand[(size_t) bin] = (int8_t) SpectralBands::getBandIndex ((double) bin * sampleRate / (double) fftSize);
+
+	summaryPower.fill (0.0);
+	summary = SairyneTrackBus::Summary{};
+	summary.bandDb.fill (SpectralBands::silenceDb);
+	framePeak.fill (0.0f);
+	frameSumSquares.fill (0.0);
+	frameCrossSum = 0.0;
+	frameSamples = 0;
+
+	working = Snapshot{};
+	working.sampleRate = sampleRate;
+	working.numChannels = channels;
+	working.spectrumDb.fill (silenceDb);
+
+	{
+		const juce::SpinLock::ScopedLockType lock (snapshotLock);
+		published = working;
+	}
+
+	droppedSamples.store (0, std::memory_order_relaxed);
+	prepared.store (true, std::memory_order_release);
+	scheduler.add (*this);
+}
+
+void SairyneAnalysisEngine::release()
+{
+	SAIRYNE_ASSERT_NOT_REALTIME();
+	prepared.store (false, std::memory_order_release);
+	scheduler.remove (*this);
+}
+
+void SairyneAnalysisEngine::pushAudio (const juce::AudioBuffer<float>& buffer) noexcept
+{
+	if (! prepared.load (std::memory_order_acquire))
+		return;
+
+	const int numSamples = buffer.getNumSamples();
+	const int numSourceChannels = buffer.getNumChannels();
+
+	if (numSamples <= 0 || numSourceChannels <= 0)
+		return;
+
+	int start1, size1, start2, size2;
+	fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+	const int numWritten = size1 + size2;
+	if (numWritten < numSamples)
+		droppedSamples.fetch_add (numSamples - numWritten, std::memory_order_relaxed);
+
+	for (int ch = 0; ch < channels; ++ch)
+	{
+		// Mono source on a stereo engine: duplicate the only channel
+		const int sourceChannel = juce::jmin (ch, numSourceChannels - 1);
+
+		if (size1 > 0)
+			fifoBuffer.copyFrom (ch, start1, buffer, sourceChannel, 0, size1);
+		if (size2 > 0)
+			fifoBuffer.copyFrom (ch, start2, buffer, sourceChannel, size1, size2);
+	}
+
+	fifo.finishedWrite (numWritten);
+}
+
+bool SairyneAnalysisEngine::getLatestSnapshot (Snapshot& dest, uint32_t lastSeenSequence) const
+{
+	SAIRYNE_ASSERT_NOT_REALTIME();
+	const juce::SpinLock::ScopedLockType lock (snapshotLock);
+
+	if (published.sequence == lastSeenSequence)
+		return false;
+
+	dest = published;
+	return true;
+}
+
+bool SairyneAnalysisEngine::processPendingAudio()
+{
+	bool didWork = false;
+	int hops = 0;
+
+	while (hops < maxHopsPerPass)
+	{
+		// Never read past the next FFT hop so spectra are taken at exact hop boundaries
+		const int wanted = juce::jmin (fifo.getNumReady(), hopSize - samplesSinceLastFft);
+		if (wanted <= 0)
+			break;
+
+		int start1, size1, start2, size2;
+		fifo.prepareToRead (wanted, start1, size1, start2, size2);
+
+		for (int ch = 0; ch < channels; ++ch)
+		{
+			if (size1 > 0)
+				chunkBuffer.copyFrom (ch, 0, fifoBuffer, ch, start1, size1);
+			if (size2 > 0)
+				chunkBuffer.copyFrom (ch, size1, fifoBuffer, ch, start2, size2);
+		}
+
+		fifo.finishedRead (size1 + size2);
+		analyseChunk (size1 + size2);
+		didWork = true;
+
+		if (samplesSinceLastFft == 0)
+			++hops;
+	}
+
+	return didWork;
+}
+
+void SairyneAnalysisEngine::analyseChunk (int numSamples)
+{
+	const float* const* data = chunkBuffer.getArrayOfReadPointers();
+
+	loudness.process (data, channels, numSamples);
+
+	for (int ch = 0; ch < channels; ++ch)
+	{
+		const auto range = juce::FloatVectorOperations::findMinAndMax (data[ch], numSamples);
+		framePeak[(size_t) ch] = juce::jmax (framePeak[(size_t) ch], std::abs (range.getStart()), std::abs (range.getEnd()));
+		frameSumSquares[(size_t) ch] += sumOfProducts (data[ch], data[ch], numSamples);
+	}
+
+	if (channels > 1)
+		frameCrossSum += sumOfProducts (data[0], data[1], numSamples);
+
+	frameSamples += numSamples;
+
+	// Mono mix into the FFT history ring (at most two contiguous regions)
+	const float gain = 1.0f / (float) channels;
+	int remaining = numSamples, offset = 0;
+
+	while (remaining > 0)
+	{
+		const int run = juce::jmin (remaining, fftSize - fftHistoryWrite);
+		float* dest = fftHistory.data() + fftHistoryWrite;
+
+		juce::FloatVectorOperations::copyWithMultiply (dest, data[0] + offset, gain, run);
+		for (int ch = 1; ch < channels; ++ch)
+			juce::FloatVectorOperations::addWithMultiply (dest, data[ch] + offset, gain, run);
+
+		fftHistoryWrite = (fftHistoryWrite + run) % fftSize;
+		offset += run;
+		remaining -= run;
+	}
+
+	samplesSinceLastFft += numSamples;
+
+	if (samplesSinceLastFft >= hopSize)
+	{
+		samplesSinceLastFft = 0;
+
+		if (++hopsSinceSpectrum >= summaryHopInterval || detailed.load (std::memory_order_relaxed))
+		{
+			computeSpectrum (hopsSinceSpectrum * hopSize);
+			publishSnapshot();
+			hopsSinceSpectrum = 0;
+		}
+	}
+}
+
+void SairyneAnalysisEngine::computeSpectrum (int samplesSinceLastSpectrum)
+{
+	// Unroll the history ring (oldest sample first) into the FFT workspace
+	const int tail = fftSize - fftHistoryWrite;
+	juce::FloatVectorOperations::copy (fftWorkspace.data(), fftHistory.data() + fftHistoryWrite, tail);
+	juce::FloatVectorOperations::copy (fftWorkspace.data() + tail, fftHistory.data(), fftHistoryWrite);
+
+	window.multiplyWithWindowingTable (fftWorkspace.data(), (size_t) fftSize);
+	fft.performFrequencyOnlyForwardTransform (fftWorkspace.data(), true);
+
+	// Scale so a full-scale sine reads 0 dBFS (Hann coherent gain = 0.5)
+	const float scale = 4.0f / (float) fftSize;
+	juce::FloatVectorOperations::multiply (fftWorkspace.data(), scale, numSpectrumBins);
+
+	// Track summary: band mean-square power (a sine of amplitude A reads A^2/2 once the
+	// Hann main lobe's 1.5 bins of noise bandwidth are divided out), averaged over ~1 s
+	std::array<double, SpectralBands::numBands> bandPower {};
+	for (int bin = 1; bin < numSpectrumBins; ++bin)
+	{
+		const int band = binToBand[(size_t) bin];
+		if (band >= 0)
+			bandPower[(size_t) band] += (double) fftWorkspace[(size_t) bin] * (double) fftWorkspace[(size_t) bin] / 3.0;
+	}
+
+	const double alpha = 1.0 - std::exp (-(double) samplesSinceLastSpectrum / (summaryTimeConstantSeconds * currentSampleRate));
+	for (size_t band = 0; band < bandPower.size(); ++band)
+	{
+		summaryPower[band] += alpha * (bandPower[band] - summaryPower[band]);
+		summary.bandDb[band] = SpectralBands::powerToDb (summaryPower[band]);
+	}
+
+	for (int bin = 0; bin < numSpectrumBins; ++bin)
+	{
+		const float db = toDb ((double) fftWorkspace[(size_t) bin]);
+		float& smoothed = working.spectrumDb[(size_t) bin];
+
+		// Fast attack, slow release so the UI does not flicker at 30-60 fps
+		smoothed = db > smoothed ? db : smoothed + 0.25f * (db - smoothed);
+	}
+}
+
+void SairyneAnalysisEngine::publishSnapshot()
+{
+	for (int ch = 0; ch < channels; ++ch)
+	{
+		working.peakDb[(size_t) ch] = toDb ((double) framePeak[(size_t) ch]);
+		working.rmsDb[(size_t) ch] = frameSamples > 0 ? toDb (std::sqrt (frameSumSquares[(size_t) ch] / (double) frameSamples))
+		                                               : silenceDb;
+	}
+
+	if (channels > 1)
+	{
+		const double denominator = std::sqrt (frameSumSquares[0] * frameSumSquares[1]);
+		working.correlation = denominator > 1.0e-12 ? (float) juce::jlimit (-1.0, 1.0, frameCrossSum / denominator) : 0.0f;
+	}
+	else
+	{
+		working.correlation = 1.0f;
+	}
+
+	working.momentaryLufs = loudness.getMomentaryLufs();
+	working.shortTermLufs = loudness.getShortTermLufs();
+	working.integratedLufs = loudness.getIntegratedLufs();
+	++working.sequence;
+
+	framePeak.fill (0.0f);
+	frameSumSquares.fill (0.0);
+	frameCrossSum = 0.0;
+	frameSamples = 0;
+
+	summary.shortTermLufs = working.shortTermLufs;
+	trackBus.publish (trackSlot, summary);
+
+	const juce::SpinLock::ScopedLockType lock (snapshotLock);
+	published = working;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "LoudnessMeter.h"
+#include "SairyneTrackBus.h"
+
+class SairyneAnalysisScheduler;
+
+// Real-time analysis of the track this instance sits on.
+//
+// The audio thread only copies samples into a lock-free SPSC FIFO (juce::AbstractFifo)
+// that prepare() sizes up front. The process-wide SairyneAnalysisScheduler thread drains
+// the FIFO and runs the windowed FFT, LUFS metering, RMS/peak and stereo correlation, then
+// publishes an immutable Snapshot that the message thread can copy out at its own pace,
+// plus a 1/3-octave summary on the shared SairyneTrackBus for cross-track masking.
+//
+// Without an open editor (setDetailed (false)) nobody draws the spectrum, so the FFT only
+// runs every summaryHopInterval hops - enough for the ~1 s averaged track summary.
+class SairyneAnalysisEngine
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+    static constexpr int numSpectrumBins = fftSize / 2;
+    static constexpr int maxChannels = LoudnessMeter::maxChannels;
+    static constexpr float silenceDb = -100.0f;
+    static constexpr int summaryHopInterval = 4;
+    static constexpr int maxHopsPerPass = 8;             // keeps one busy track from starving the others
+    static constexpr double summaryTimeConstantSeconds = 1.0;
+
+    struct Snapshot
+    {
+        uint32_t sequence = 0;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+
+        std::array<float, maxChannels> peakDb {};
+        std::array<float, maxChannels> rmsDb {};
+        float correlation = 0.0f;
+
+        float momentaryLufs = LoudnessMeter::silenceLufs;
+        float shortTermLufs = LoudnessMeter::silenceLufs;
+        float integratedLufs = LoudnessMeter::silenceLufs;
+
+        std::array<float, numSpectrumBins> spectrumDb {};
+    };
+
+    SairyneAnalysisEngine (SairyneAnalysisScheduler& scheduler, SairyneTrackBus& trackBus);
+    ~SairyneAnalysisEngine();
+
+    // Message thread (prepareToPlay / releaseResources). Allocates.
+    void prepare (double sampleRate, int maximumBlockSize, int numChannels);
+    void release();
+
+    // Audio thread. Never allocates, locks or logs; drops samples if the FIFO is full.
+    void pushAudio (const juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Any non-audio thread. Copies the newest snapshot if it is newer than lastSeenSequence.
+    bool getLatestSnapshot (Snapshot& dest, uint32_t lastSeenSequence) const;
+
+    // Samples the audio thread could not queue because the analysis thread fell behind.
+    int64_t getDroppedSampleCount() const noexcept { return droppedSamples.load (std::memory_order_relaxed); }
+
+    // Full-rate spectrum only while someone is looking at it
+    void setDetailed (bool shouldBeDetailed) noexcept { detailed.store (shouldBeDetailed, std::memory_order_relaxed); }
+
+    // This instance's slot on the shared track bus (-1 if the bus was full)
+    int getTrackSlot() const noexcept { return trackSlot; }
+
+    // Scheduler thread only. Analyses up to maxHopsPerPass hops; false if nothing was queued.
+    bool processPendingAudio();
+
+private:
+    void analyseChunk (int numSamples);
+    void computeSpectrum (int samplesSinceLastSpectrum);
+    void publishSnapshot();
+
+    // Audio thread -> analysis thread
+    juce::AbstractFifo fifo { 1 };
+    juce::AudioBuffer<float> fifoBuffer;
+    std::atomic<bool> prepared { false };
+    std::atomic<int64_t> droppedSamples { 0 };
+    std::atomic<bool> detailed { false };
+    int channels = 0;
+
+    SairyneAnalysisScheduler& scheduler;
+    SairyneTrackBus& trackBus;
+    const int trackSlot;
+
+    // Analysis thread only
+    juce::AudioBuffer<float> chunkBuffer;
+    LoudnessMeter loudness;
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+    std::array<float, fftSize> fftHistory {};
+    std::array<float, fftSize * 2> fftWorkspace {};
+    int fftHistoryWrite = 0;
+    int samplesSinceLastFft = 0;
+    int hopsSinceSpectrum = 0;
+    double currentSampleRate = 48000.0;
+
+    std::array<int8_t, numSpectrumBins> binToBand {};
+    std::array<double, SpectralBands::numBands> summaryPower {};
+    SairyneTrackBus::Summary summary;
+
+    std::array<float, maxChannels> framePeak {};
+    std::array<double, maxChannels> frameSumSquares {};
+    double frameCrossSum = 0.0;
+    int frameSamples = 0;
+
+    Snapshot working;
+
+    // Analysis thread -> readers. Neither side is the audio thread, so a spin lock is fine here.
+    mutable juce::SpinLock snapshotLock;
+    Snapshot published;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneAnalysisEngine)
+};
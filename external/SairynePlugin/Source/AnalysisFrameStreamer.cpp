@@ -0,0 +1,190 @@
+#include "AnalysisFrameStreamer.h"
+#include "SairyneLog.h"
+#include <cmath>
+#include <utility>
+
+namespace
+{
+	// If the page stops acknowledging (reload), resume after this long
+	constexpr juce::uint32 ackTimeoutMs = 1000;
+
+	juce::var makeChannelArray (const std::array<float, SairyneAnalysisEngine::maxChannels>& values, int numChannels)
+	{
+		juce::Array<juce::var> result;
+		for (int ch = 0; ch < numChannels; ++ch)
+			result.add (values[(size_t) ch]);
+		return result;
+	}
+}
+
+AnalysisFrameStreamer::AnalysisFrameStreamer (SairyneAnalysisEngine& e, juce::WebBrowserComponent& b, SairyneDiagnostics& d)
+	: engine (e), browser (b), diagnostics (d)
+{
+}
+
+AnalysisFrameStreamer::~AnalysisFrameStreamer()
+{
+	stopTimer();
+}
+
+void AnalysisFrameStreamer::handleSubscribe (const juce::var& payload)
+{
+	int fps = defaultFramesPerSecond;
+
+	if (const auto* obj = payload.getDynamicObject())
+	{
+		if (obj->hasProperty("fps"))
+			fps = (int) obj->getProperty("fps");
+	}
+	else if (payload.isInt() || payload.isDouble())
+	{
+		fps = (int) payload;
+	}
+
+	if (fps <= 0)
+	{
+		stopTimer();
+		SAIRYNE_LOG_DEBUG("AnalysisFrameStreamer: stopped (sent " + juce::String((juce::int64) stats.sent)
+			+ ", coalesced " + juce::String((juce::int64) stats.coalesced)
+			+ ", backpressured " + juce::String((juce::int64) stats.backpressured)
+			+ ", hidden " + juce::String((juce::int64) stats.hidden)
+			+ ", resumed " + juce::String((juce::int64) stats.resumed) + ")");
+		return;
+	}
+
+	fps = juce::jlimit (1, maxFramesPerSecond, fps);
+	lastAckedFrame = lastSentFrame;
+	lastAckTime = juce::Time::getMillisecondCounter();
+	startTimerHz (fps);
+}
+
+void AnalysisFrameStreamer::handleAck (const juce::var& payload)
+{
+	juce::int64 frame = 0;
+
+	if (const auto* obj = payload.getDynamicObject())
+		frame = (juce::int64) obj->getProperty("seq");
+	else
+		frame = (juce::int64) payload;
+
+	if (frame > 0 && (uint64_t) frame > lastAckedFrame && (uint64_t) frame <= lastSentFrame)
+	{
+		if (lastSentFrame - (uint64_t) frame < sentTicks.size())
+			diagnostics.analysisFrameRoundTripMicros.record (SairyneDiagnostics::getMicrosSince (sentTicks[(size_t) frame % sentTicks.size()]));
+
+		lastAckedFrame = (uint64_t) frame;
+		lastAckTime = juce::Time::getMillisecondCounter();
+	}
+}
+
+void AnalysisFrameStreamer::timerCallback()
+{
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+
+	const auto now = juce::Time::getMillisecondCounter();
+
+	if (! browser.isShowing())
+	{
+		// Nothing is sent, so nothing new goes in flight
+		++stats.hidden;
+		wasHidden = true;
+		return;
+	}
+
+	if (std::exchange (wasHidden, false))
+	{
+		// Frames sent just before it was hidden may never be acknowledged (the page doesn't
+		// paint while hidden): start with an empty window instead of waiting out ackTimeoutMs,
+		// and send the first frame in full rather than counting the gap as coalesced
+		++stats.resumed;
+		lastAckedFrame = lastSentFrame;
+		lastAckTime = now;
+		lastSentSequence = 0;
+	}
+
+	if (lastSentFrame - lastAckedFrame >= (uint64_t) maxFramesInFlight)
+	{
+		if (now - lastAckTime < ackTimeoutMs)
+		{
+			++stats.backpressured;
+			return;
+		}
+
+		// Page dropped our frames (reload) - start over
+		lastAckedFrame = lastSentFrame;
+		lastAckTime = now;
+	}
+
+	if (! engine.getLatestSnapshot (snapshot, lastSentSequence))
+		return;
+
+	if (lastSentSequence != 0 && snapshot.sequence > lastSentSequence + 1)
+		stats.coalesced += snapshot.sequence - lastSentSequence - 1;
+
+	lastSentSequence = snapshot.sequence;
+	jassert (lastSentFrame - lastAckedFrame < (uint64_t) maxFramesInFlight);
+	++lastSentFrame;
+	sentTicks[(size_t) (lastSentFrame % sentTicks.size())] = juce::Time::getHighResolutionTicks();
+
+	browser.emitEventIfBrowserIsVisible ("analysisFrame", encodeFrame());
+	++stats.sent;
+
+	stats.messageThreadMs += juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks) * 1000.0;
+}
+
+void AnalysisFrameStreamer::buildBandTable (double sampleRate)
+{
+	// Log-spaced bands from 20 Hz to Nyquist, each covering at least one FFT bin
+	const double binHz = sampleRate / (double) SairyneAnalysisEngine::fftSize;
+	const double lowHz = 20.0, highHz = sampleRate * 0.5;
+
+	int previous = 1;
+	for (int band = 0; band <= numBands; ++band)
+	{
+		const double hz = lowHz * std::pow (highHz / lowHz, (double) band / (double) numBands);
+		int bin = juce::jlimit (1, SairyneAnalysisEngine::numSpectrumBins, (int) std::round (hz / binHz));
+		if (band > 0)
+			bin = juce::jmax (bin, juce::jmin (previous + 1, SairyneAnalysisEngine::numSpectrumBins));
+		bandEdges[(size_t) band] = bin;
+		previous = bin;
+	}
+
+	bandTableSampleRate = sampleRate;
+}
+
+juce::var AnalysisFrameStreamer::encodeFrame()
+{
+	if (snapshot.sampleRate != bandTableSampleRate)
+		buildBandTable (snapshot.sampleRate);
+
+	for (int band = 0; band < numBands; ++band)
+	{
+		const int first = bandEdges[(size_t) band];
+		const int last = juce::jmax (first + 1, bandEdges[(size_t) band + 1]);
+		float peak = SairyneAnalysisEngine::silenceDb;
+
+		for (int bin = first; bin < last && bin < SairyneAnalysisEngine::numSpectrumBins; ++bin)
+			peak = juce::jmax (peak, snapshot.spectrumDb[(size_t) bin]);
+
+		bands[(size_t) band] = peak;
+	}
+
+	auto* frame = new juce::DynamicObject();
+	frame->setProperty("seq", (juce::int64) lastSentFrame);
+	frame->setProperty("sampleRate", snapshot.sampleRate);
+	frame->setProperty("peakDb", makeChannelArray (snapshot.peakDb, snapshot.numChannels));
+	frame->setProperty("rmsDb", makeChannelArray (snapshot.rmsDb, snapshot.numChannels));
+	frame->setProperty("correlation", snapshot.correlation);
+	frame->setProperty("momentaryLufs", snapshot.momentaryLufs);
+	frame->setProperty("shortTermLufs", snapshot.shortTermLufs);
+	frame->setProperty("integratedLufs", snapshot.integratedLufs);
+	frame->setProperty("bandCount", numBands);
+	// Little-endian float32 bytes; the page decodes straight into a Float32Array
+	frame->setProperty("bands", juce::Base64::toBase64 (bands.data(), sizeof (float) * bands.size()));
+	frame->setProperty("sent", (juce::int64) stats.sent);
+	frame->setProperty("coalesced", (juce::int64) stats.coalesced);
+	frame->setProperty("backpressured", (juce::int64) stats.backpressured);
+	frame->setProperty("hidden", (juce::int64) stats.hidden);
+	frame->setProperty("resumed", (juce::int64) stats.resumed);
+	return juce::var (frame);
+}
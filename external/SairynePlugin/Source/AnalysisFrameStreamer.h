@@ -0,0 +1,70 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "AnalysisEngine.h"
+#include "SairyneDiagnostics.h"
+
+// Streams analysis snapshots into the WebView as compact binary frames.
+//
+// Runs on the message thread only. Each timer tick takes just the newest snapshot
+// (intermediate ones are coalesced), packs the spectrum as base64 Float32Array bytes,
+// and emits a single "analysisFrame" event. The page acknowledges each frame it has
+// rendered ("analysisAck"); while too many frames are unacknowledged, ticks are skipped
+// so a busy page never builds up a queue of pending evaluateJavascript work.
+// While the view is hidden nothing is sent (emitEventIfBrowserIsVisible would drop it),
+// and when it shows again the in-flight window starts empty, so frames the hidden page
+// never acknowledged don't hold the stream back.
+// Send-to-ack times go to SairyneDiagnostics::analysisFrameRoundTripMicros.
+class AnalysisFrameStreamer : private juce::Timer
+{
+public:
+    static constexpr int numBands = 256;          // log-spaced bands sent to the UI
+    static constexpr int maxFramesInFlight = 2;
+    static constexpr int defaultFramesPerSecond = 30;
+    static constexpr int maxFramesPerSecond = 60;
+
+    struct Stats
+    {
+        uint64_t sent = 0;
+        uint64_t coalesced = 0;      // engine frames superseded before they could be sent
+        uint64_t backpressured = 0;  // ticks skipped because the page had not caught up
+        uint64_t hidden = 0;         // ticks skipped because the view was hidden
+        uint64_t resumed = 0;        // times the view showed again (in-flight window reset)
+        double messageThreadMs = 0.0;
+    };
+
+    AnalysisFrameStreamer (SairyneAnalysisEngine& engine, juce::WebBrowserComponent& browser, SairyneDiagnostics& diagnostics);
+    ~AnalysisFrameStreamer() override;
+
+    // Page -> native: { fps: n } starts streaming, { fps: 0 } stops it
+    void handleSubscribe (const juce::var& payload);
+    // Page -> native: { seq: n } once frame n has been rendered
+    void handleAck (const juce::var& payload);
+
+    const Stats& getStats() const noexcept { return stats; }
+
+private:
+    void timerCallback() override;
+    void buildBandTable (double sampleRate);
+    juce::var encodeFrame();
+
+    SairyneAnalysisEngine& engine;
+    juce::WebBrowserComponent& browser;
+    SairyneDiagnostics& diagnostics;
+
+    SairyneAnalysisEngine::Snapshot snapshot;
+    uint32_t lastSentSequence = 0;
+    uint64_t lastSentFrame = 0;
+    uint64_t lastAckedFrame = 0;
+    juce::uint32 lastAckTime = 0;
+    bool wasHidden = false;
+    std::array<juce::int64, 8> sentTicks {};   // by frame number, for the round-trip time
+
+    double bandTableSampleRate = 0.0;
+    std::array<int, numBands + 1> bandEdges {};
+    std::array<float, numBands> bands {};
+
+    Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisFrameStreamer)
+};
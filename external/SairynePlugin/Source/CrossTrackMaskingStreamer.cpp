@@ -0,0 +1,81 @@
+#include "CrossTrackMaskingStreamer.h"
+#include "PluginProcessor.h"
+
+CrossTrackMaskingStreamer::CrossTrackMaskingStreamer (SairyneAudioProcessor& p, juce::WebBrowserComponent& b)
+	: processor (p), browser (b)
+{
+	tracks.reserve ((size_t) SairyneTrackBus::maxTracks);
+	startTimerHz (updatesPerSecond);
+}
+
+CrossTrackMaskingStreamer::~CrossTrackMaskingStreamer()
+{
+	stopTimer();
+}
+
+void CrossTrackMaskingStreamer::timerCallback()
+{
+	const bool isMaster = processor.isMasterTrack();
+
+	if (! isMaster)
+	{
+		// Tell the page once that this instance stopped being the master
+		if (wasMaster)
+		{
+			auto* obj = new juce::DynamicObject();
+			obj->setProperty("active", false);
+			browser.emitEventIfBrowserIsVisible ("crossTrackMasking", juce::var (obj));
+		}
+
+		wasMaster = false;
+		return;
+	}
+
+	wasMaster = true;
+
+	auto& bus = processor.getTrackBus();
+	bus.getActiveTracks (tracks, processor.getAnalysisEngine().getTrackSlot());
+	SairyneTrackBus::findConflicts (tracks, conflicts, maxConflicts);
+
+	browser.emitEventIfBrowserIsVisible ("crossTrackMasking", encode());
+}
+
+juce::var CrossTrackMaskingStreamer::encode() const
+{
+	juce::Array<juce::var> trackList;
+	for (const auto& track : tracks)
+	{
+		auto* obj = new juce::DynamicObject();
+		obj->setProperty("slot", track.slot);
+		obj->setProperty("name", track.name);
+		obj->setProperty("shortTermLufs", track.summary.shortTermLufs);
+		trackList.add (juce::var (obj));
+	}
+
+	juce::Array<juce::var> conflictList;
+	for (const auto& conflict : conflicts)
+	{
+		juce::Array<juce::var> bandList;
+		for (const auto& band : conflict.bands)
+		{
+			auto* entry = new juce::DynamicObject();
+			entry->setProperty("band", band.first);
+			entry->setProperty("hz", SpectralBands::getCentreHz (band.first));
+			entry->setProperty("severity", band.second);
+			bandList.add (juce::var (entry));
+		}
+
+		auto* obj = new juce::DynamicObject();
+		obj->setProperty("a", conflict.trackA);
+		obj->setProperty("b", conflict.trackB);
+		obj->setProperty("score", conflict.score);
+		obj->setProperty("bands", bandList);
+		conflictList.add (juce::var (obj));
+	}
+
+	auto* result = new juce::DynamicObject();
+	result->setProperty("active", true);
+	result->setProperty("tracks", trackList);
+	result->setProperty("conflicts", conflictList);
+	return juce::var (result);
+}
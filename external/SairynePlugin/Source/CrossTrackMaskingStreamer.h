@@ -0,0 +1,32 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include "SairyneTrackBus.h"
+
+class SairyneAudioProcessor;
+
+// Master-instance view of the other tracks: a couple of times per second, reads every
+// track summary from the shared SairyneTrackBus, scores pairwise masking and emits one
+// "crossTrackMasking" event. Message thread only; idle unless the instance is the master.
+class CrossTrackMaskingStreamer : private juce::Timer
+{
+public:
+    static constexpr int updatesPerSecond = 2;
+    static constexpr int maxConflicts = 50;
+
+    CrossTrackMaskingStreamer (SairyneAudioProcessor& processor, juce::WebBrowserComponent& browser);
+    ~CrossTrackMaskingStreamer() override;
+
+private:
+    void timerCallback() override;
+    juce::var encode() const;
+
+    SairyneAudioProcessor& processor;
+    juce::WebBrowserComponent& browser;
+
+    std::vector<SairyneTrackBus::Track> tracks;
+    std::vector<SairyneTrackBus::Conflict> conflicts;
+    bool wasMaster = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CrossTrackMaskingStreamer)
+};
@@ -0,0 +1,66 @@
+#include "DiagnosticsStreamer.h"
+#include "RealtimeContext.h"
+#include "SairyneServices.h"
+
+DiagnosticsStreamer::DiagnosticsStreamer (SairyneServices& s, juce::WebBrowserComponent& b)
+	: services (s), browser (b)
+{
+}
+
+DiagnosticsStreamer::~DiagnosticsStreamer()
+{
+	stopTimer();
+}
+
+void DiagnosticsStreamer::handleSubscribe (const juce::var& payload)
+{
+	int intervalMs = defaultIntervalMs;
+
+	if (const auto* obj = payload.getDynamicObject())
+	{
+		if (obj->hasProperty("intervalMs"))
+			intervalMs = (int) obj->getProperty("intervalMs");
+	}
+	else if (payload.isInt() || payload.isDouble())
+	{
+		intervalMs = (int) payload;
+	}
+
+	if (intervalMs <= 0)
+	{
+		stopTimer();
+		return;
+	}
+
+	startTimer (juce::jmax (minIntervalMs, intervalMs));
+	timerCallback();
+}
+
+void DiagnosticsStreamer::timerCallback()
+{
+	browser.emitEventIfBrowserIsVisible ("diagnostics", encode());
+}
+
+juce::var DiagnosticsStreamer::encode() const
+{
+	auto result = services.getDiagnostics().toVar();
+	auto* obj = result.getDynamicObject();
+
+	const auto& storeStats = services.getStore().getStats();
+	auto* store = new juce::DynamicObject();
+	store->setProperty("getMicros", storeStats.getMicros.toVar());
+	store->setProperty("setMicros", storeStats.setMicros.toVar());
+	store->setProperty("flushMicros", storeStats.flushMicros.toVar());
+	store->setProperty("compactionMicros", storeStats.compactionMicros.toVar());
+	store->setProperty("recordsWritten", (juce::int64) storeStats.recordsWritten.load());
+	store->setProperty("bytesWritten", (juce::int64) storeStats.bytesWritten.load());
+	store->setProperty("batchesWritten", (juce::int64) storeStats.batchesWritten.load());
+	store->setProperty("compactions", (juce::int64) storeStats.compactions.load());
+
+	obj->setProperty("store", juce::var (store));
+	obj->setProperty("instances", services.getNumInstances());
+	obj->setProperty("analysisEngines", services.getAnalysisScheduler().getNumEngines());
+	// Only counted in builds with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1
+	obj->setProperty("realtimeAllocations", SairyneRealtimeScope::getAllocationViolationCount());
+	return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <JuceHeader.h>
+
+class SairyneServices;
+
+// Sends the process-wide performance counters (SairyneDiagnostics, the store's latencies
+// and write stats) to the page as one "diagnostics" event per interval, while the page
+// has asked for them. Message thread only; idle until subscribed.
+class DiagnosticsStreamer : private juce::Timer
+{
+public:
+    static constexpr int defaultIntervalMs = 1000;
+    static constexpr int minIntervalMs = 250;
+
+    DiagnosticsStreamer (SairyneServices& services, juce::WebBrowserComponent& browser);
+    ~DiagnosticsStreamer() override;
+
+    // Page -> native: { intervalMs: n } starts (and sends one right away), { intervalMs: 0 } stops
+    void handleSubscribe (const juce::var& payload);
+
+private:
+    void timerCallback() override;
+    juce::var encode() const;
+
+    SairyneServices& services;
+    juce::WebBrowserComponent& browser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagnosticsStreamer)
+};
@@ -0,0 +1,193 @@
+#include "LoudnessMeter.h"
+#include <cmath>
+
+LoudnessMeter::LoudnessMeter()
+{
+	prepare (48000.0, 2);
+}
+
+void LoudnessMeter::prepare (double sampleRate, int numChannels)
+{
+	channels = juce::jlimit (1, maxChannels, numChannels);
+	subBlockLength = juce::jmax (1, juce::roundToInt (sampleRate * 0.1));
+
+	// K-weighting for an arbitrary sample rate (BS.1770-4, same derivation as libebur128)
+	{
+		const double f0 = 1681.974450955533;
+		const double gainDb = 3.999843853973347;
+		const double q = 0.7071752369554196;
+		const double k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+		const double vh = std::pow (10.0, gainDb / 20.0);
+		const double vb = std::pow (vh, 0.4996667741545416);
+		const double a0 = 1.0 + k / q + k * k;
+
+		shelf.b0 = (vh + vb * k / q + k * k) / a0;
+		shelf.b1 = 2.0 * (k * k - vh) / a0;
+		shelf.b2 = (vh - vb * k / q + k * k) / a0;
+		shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+		shelf.a2 = (1.0 - k / q + k * k) / a0;
+	}
+	{
+		const double f0 = 38.13547087602444;
+		const double q = 0.5003270373238773;
+		const double k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+		const double a0 = 1.0 + k / q + k * k;
+
+		highPass.b0 = 1.0;
+		highPass.b1 = -2.0;
+		highPass.b2 = 1.0;
+		highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+		highPass.a2 = (1.0 - k / q + k * k) / a0;
+	}
+
+	reset();
+}
+
+void LoudnessMeter::reset()
+{
+	shelf.z1.fill (0.0);
+	shelf.z2.fill (0.0);
+	highPass.z1.fill (0.0);
+	highPass.z2.fill (0.0);
+
+	subBlockFill = 0;
+	subBlockEnergy = 0.0;
+	subBlocks.fill (0.0);
+	subBlockWrite = 0;
+	subBlocksAvailable = 0;
+
+	gateCounts.fill (0);
+	gateEnergies.fill (0.0);
+}
+
+void LoudnessMeter::process (const float* const* channelData, int numChannels, int numSamples) noexcept
+{
+	const int numToMeter = juce::jmin (numChannels, channels);
+	int offset = 0;
+
+	while (offset < numSamples)
+	{
+		const int chunk = juce::jmin (numSamples - offset, subBlockLength - subBlockFill);
+
+		for (int ch = 0; ch < numToMeter; ++ch)
+		{
+			const float* in = channelData[ch] + offset;
+			double sum = 0.0;
+
+			for (int i = 0; i < chunk; ++i)
+			{
+				const double y = highPass.process (shelf.process ((double) in[i], ch), ch);
+				sum += y * y;
+			}
+
+			// Channel weights are 1.0 for L/R (and mono), so energies simply add up
+			subBlockEnergy += sum;
+		}
+
+		subBlockFill += chunk;
+		offset += chunk;
+
+		if (subBlockFill >= subBlockLength)
+			finishSubBlock();
+	}
+}
+
+void LoudnessMeter::finishSubBlock() noexcept
+{
+	subBlocks[(size_t) subBlockWrite] = subBlockEnergy / (double) subBlockLength;
+	subBlockWrite = (subBlockWrite + 1) % subBlocksPerShortTerm;
+	subBlocksAvailable = juce::jmin (subBlocksAvailable + 1, subBlocksPerShortTerm);
+	subBlockFill = 0;
+	subBlockEnergy = 0.0;
+
+	// Every 100 ms a new 400 ms gating block (75% overlap) completes
+	if (subBlocksAvailable < subBlocksPerMomentary)
+		return;
+
+	const double blockEnergy = meanOfLastSubBlocks (subBlocksPerMomentary);
+	const float blockLufs = energyToLufs (blockEnergy);
+
+	if (blockLufs < histogramMinLufs)
+		return;
+
+	const int bin = juce::jlimit (0, histogramBins - 1, (int) ((blockLufs - histogramMinLufs) / histogramStepLu));
+	++gateCounts[(size_t) bin];
+	gateEnergies[(size_t) bin] += blockEnergy;
+}
+
+double LoudnessMeter::meanOfLastSubBlocks (int count) const noexcept
+{
+	count = juce::jmin (count, subBlocksAvailable);
+	if (count <= 0)
+		return 0.0;
+
+	double sum = 0.0;
+	for (int i = 1; i <= count; ++i)
+		sum += subBlocks[(size_t) ((subBlockWrite - i + subBlocksPerShortTerm) % subBlocksPerShortTerm)];
+
+	return sum / (double) count;
+}
+
+float LoudnessMeter::energyToLufs (double energy) noexcept
+{
+	if (energy <= 1.0e-12)
+		return silenceLufs;
+
+	return (float) (-0.691 + 10.0 * std::log10 (energy));
+}
+
+float LoudnessMeter::getMomentaryLufs() const noexcept
+{
+	if (subBlocksAvailable < subBlocksPerMomentary)
+		return silenceLufs;
+
+	return energyToLufs (meanOfLastSubBlocks (subBlocksPerMomentary));
+}
+
+float LoudnessMeter::getShortTermLufs() const noexcept
+{
+	return energyToLufs (meanOfLastSubBlocks (subBlocksPerShortTerm));
+}
+
+float LoudnessMeter::getIntegratedLufs() const noexcept
+{
+	// Pass 1: absolute gate (-70 LUFS) is already applied when binning
+	double totalEnergy = 0.0;
+	uint64_t totalCount = 0;
+
+	for (int i = 0; i < histogramBins; ++i)
+	{
+		totalEnergy += gateEnergies[(size_t) i];
+		totalCount += gateCounts[(size_t) i];
+	}
+
+	if (totalCount == 0)
+		return silenceLufs;
+
+	// Pass 2: relative gate 10 LU below the absolute-gated mean
+	const float relativeGate = energyToLufs (totalEnergy / (double) totalCount) - 10.0f;
+	const int firstBin = juce::jlimit (0, histogramBins - 1, (int) std::ceil ((relativeGate - histogramMinLufs) / histogramStepLu));
+
+	double gatedEnergy = 0.0;
+	uint64_t gatedCount = 0;
+
+	for (int i = firstBin; i < histogramBins; ++i)
+	{
+		gatedEnergy += gateEnergies[(size_t) i];
+		gatedCount += gateCounts[(size_t) i];
+	}
+
+	if (gatedCount == 0)
+		return silenceLufs;
+
+	return energyToLufs (gatedEnergy / (double) gatedCount);
+}
+
+void LoudnessMeter::mergeGatingHistogram (const LoudnessMeter& other) noexcept
+{
+	for (int i = 0; i < histogramBins; ++i)
+	{
+		gateCounts[(size_t) i] += other.gateCounts[(size_t) i];
+		gateEnergies[(size_t) i] += other.gateEnergies[(size_t) i];
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+// ITU-R BS.1770 / EBU R128 loudness meter (momentary, short-term, integrated).
+// All state is fixed-size, so process() never allocates. Integrated loudness uses
+// a 0.1 LU gating histogram instead of storing every block, which keeps memory
+// constant for arbitrarily long sessions and lets offline segments be merged.
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr float silenceLufs = -100.0f;
+
+    LoudnessMeter();
+
+    void prepare (double sampleRate, int numChannels);
+    void reset();
+
+    void process (const float* const* channelData, int numChannels, int numSamples) noexcept;
+
+    float getMomentaryLufs() const noexcept;     // 400 ms window
+    float getShortTermLufs() const noexcept;     // 3 s window
+    float getIntegratedLufs() const noexcept;    // gated, since reset()
+
+    // Adds another meter's gating blocks (offline analysis of adjacent segments).
+    void mergeGatingHistogram (const LoudnessMeter& other) noexcept;
+
+private:
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        std::array<double, maxChannels> z1 {}, z2 {};
+
+        inline double process (double x, int ch) noexcept
+        {
+            const double y = b0 * x + z1[(size_t) ch];
+            z1[(size_t) ch] = b1 * x - a1 * y + z2[(size_t) ch];
+            z2[(size_t) ch] = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    static constexpr int subBlocksPerMomentary = 4;    // 4 x 100 ms
+    static constexpr int subBlocksPerShortTerm = 30;   // 30 x 100 ms
+    static constexpr float histogramMinLufs = -70.0f;  // absolute gate
+    static constexpr float histogramStepLu = 0.1f;
+    static constexpr int histogramBins = 800;          // -70 .. +10 LUFS
+
+    void finishSubBlock() noexcept;
+    double meanOfLastSubBlocks (int count) const noexcept;
+    static float energyToLufs (double energy) noexcept;
+
+    Biquad shelf, highPass;
+    int channels = 0;
+    int subBlockLength = 4800;
+    int subBlockFill = 0;
+    double subBlockEnergy = 0.0;
+
+    std::array<double, subBlocksPerShortTerm> subBlocks {};
+    int subBlockWrite = 0;
+    int subBlocksAvailable = 0;
+
+    std::array<uint32_t, histogramBins> gateCounts {};
+    std::array<double, histogramBins> gateEnergies {};
+};
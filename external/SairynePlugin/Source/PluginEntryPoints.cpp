@@ -0,0 +1,19 @@
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+// Everything that needs the editor or the plugin wrapper. Kept apart from PluginProcessor.cpp
+// so the headless targets (external/CMakeLists.txt) can build the processor without it; they
+// compile Headless/HeadlessEntryPoints.cpp instead.
+
+juce::AudioProcessorEditor* SairyneAudioProcessor::createEditor()
+{
+	SAIRYNE_LOG_DEBUG("createEditor()");
+	return new SairyneAudioProcessorEditor (*this);
+}
+
+// ========= Обязательная фабрика JUCE =========
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+	SAIRYNE_LOG_DEBUG("createPluginFilter(): constructing processor");
+	return new SairyneAudioProcessor();
+}
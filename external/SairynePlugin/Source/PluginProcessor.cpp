@@ -1,80 +1,282 @@
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-std::atomic<int> SairyneAudioProcessor::liveInstances { 0 };
+#include "RealtimeContext.h"
+#include "AnalysisFrameStreamer.h"
+#include "StemAnalysisRunner.h"
+#include "CrossTrackMaskingStreamer.h"
+#include "DiagnosticsStreamer.h"
+#include "SairyneBridgeCodec.h"
 
 SairyneAudioProcessor::SairyneAudioProcessor()
 {
-	// Настроим файл-логгер, чтобы видеть сообщения и в консоли Xcode, и в файле
-	auto logsDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
-		.getChildFile("Sairyne");
-	logsDir.createDirectory();
-	auto logFile = logsDir.getChildFile("Sairyne.log");
-	if (logFile.existsAsFile())
-		logFile.deleteFile();
-	fileLogger = std::make_unique<juce::FileLogger>(logFile, "Sairyne Debug Log", 0);
-	juce::Logger::setCurrentLogger(fileLogger.get());
-
 	// soft one-instance guard per process
-	if (++liveInstances > 1)
+	if (services->instanceCreated() > 1)
 	{
 		masterOverlay = true;
 	}
 
-	DBG("SairyneAudioProcessor constructed");
-	DBG("Log file: " + logFile.getFullPathName());
-
-	// Extra: write to stderr and /tmp for visibility even without Logger
-	std::fprintf(stderr, "[Sairyne] Processor constructed\n");
+	SAIRYNE_LOG_INFO("SairyneAudioProcessor constructed (instance " + juce::String(services->getNumInstances())
+		+ ", track slot " + juce::String(analysisEngine.getTrackSlot())
+		+ ", log file: " + services->getLogger().getLogFile().getFullPathName() + ")");
 }
 
 SairyneAudioProcessor::~SairyneAudioProcessor()
 {
-	DBG("SairyneAudioProcessor destructed");
-	--liveInstances;
-	juce::Logger::setCurrentLogger(nullptr);
-	fileLogger.reset();
-	propertiesFile.reset();
+	SAIRYNE_LOG_INFO("SairyneAudioProcessor destructed");
+	services->instanceDestroyed();
+}
+
+void SairyneAudioProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+	{
+		const juce::ScopedLock lock (trackInfoLock);
+		hostTrackName = properties.name.value_or (juce::String());
+	}
+
+	getTrackBus().setTrackName (analysisEngine.getTrackSlot(), properties.name.value_or (juce::String()));
+	updateMasterRole();
 }
 
-juce::PropertiesFile* SairyneAudioProcessor::getPropertiesFile()
+void SairyneAudioProcessor::setTrackRole (const juce::String& role)
 {
-	if (propertiesFile == nullptr)
+	const auto stored = role == "master" || role == "track" ? role : juce::String();
 	{
-		juce::PropertiesFile::Options options;
-		options.applicationName = "Sairyne";
-		options.filenameSuffix = "settings";
-		options.osxLibrarySubFolder = "Application Support";
-		options.commonToAllUsers = false;
-		options.ignoreCaseOfKeyNames = false;
-		options.doNotSave = false;
-		options.millisecondsBeforeSaving = 2000;
-		options.storageFormat = juce::PropertiesFile::StorageFormat::storeAsXML;
-		
-		propertiesFile = std::make_unique<juce::PropertiesFile>(options);
-		
-		DBG("PropertiesFile created: " + propertiesFile->getFile().getFullPathName());
-		juce::Logger::writeToLog("PropertiesFile created: " + propertiesFile->getFile().getFullPathName());
+		const juce::ScopedLock lock (trackInfoLock);
+		trackRoleOverride = stored;
 	}
-	
-	return propertiesFile.get();
+
+	if (sessionState.setValue (trackRoleSection, stored))
+		sessionStateChanged();
+
+	updateMasterRole();
+}
+
+void SairyneAudioProcessor::updateMasterRole()
+{
+	bool isMaster = false;
+	{
+		const juce::ScopedLock lock (trackInfoLock);
+
+		if (trackRoleOverride.isNotEmpty())
+		{
+			isMaster = trackRoleOverride == "master";
+		}
+		else
+		{
+			const auto name = hostTrackName.trim();
+			isMaster = name.equalsIgnoreCase ("Master") || name.equalsIgnoreCase ("Main")
+			        || name.equalsIgnoreCase ("Stereo Out") || name.startsWithIgnoreCase ("Master ");
+		}
+	}
+
+	if (masterTrack.exchange (isMaster) != isMaster)
+		SAIRYNE_LOG_INFO("Track slot " + juce::String(analysisEngine.getTrackSlot()) + (isMaster ? " is now the master" : " is no longer the master"));
+
+	getTrackBus().setMaster (analysisEngine.getTrackSlot(), isMaster);
 }
 
-juce::AudioProcessorEditor* SairyneAudioProcessor::createEditor()
+// Mirrored by isSessionKey() in src/services/audio/juceBridge.ts; change both together
+bool SairyneAudioProcessor::isSessionKey (const juce::String& key)
 {
-	DBG("createEditor()");
-	return new SairyneAudioProcessorEditor (*this);
+	return key == "sairyne_functional_chat_state_v1"
+	    || key == "sairyne_selected_project"
+	    || key.startsWith ("sairyne_session_");
+}
+
+juce::StringArray SairyneAudioProcessor::getUiSessionKeys() const
+{
+	juce::StringArray keys { "sairyne_functional_chat_state_v1", "sairyne_selected_project" };
+
+	for (const auto& name : sessionState.getNames())
+		if (isSessionKey (name))
+			keys.addIfNotAlreadyThere (name);
+
+	return keys;
+}
+
+juce::String SairyneAudioProcessor::loadUiValue (const juce::String& key)
+{
+	if (! isSessionKey (key))
+		return getStore().getValue (key);
+
+	auto value = sessionState.getValue (key);
+
+	if (value.isEmpty() && legacySessionMigrationPending.load() && migrateLegacyValue (key))
+	{
+		sessionStateChanged();
+		value = sessionState.getValue (key);
+	}
+
+	return value;
+}
+
+bool SairyneAudioProcessor::migrateLegacyValue (const juce::String& key)
+{
+	// The plugin used to keep these in the shared store; a project from then takes the value
+	// it would have shown, once per key, and saves it with the project from now on
+	const juce::ScopedLock sl (legacyMigrationLock);
+
+	if (legacyKeysMigrated.contains (key))
+		return false;
+
+	legacyKeysMigrated.add (key);
+	const auto value = getStore().getValue (key);
+
+	if (value.isEmpty() || sessionState.getValue (key).isNotEmpty() || ! sessionState.setValue (key, value))
+		return false;
+
+	SAIRYNE_LOG_INFO("Session state: migrated " + key + " from the shared store");
+	return true;
+}
+
+void SairyneAudioProcessor::startLegacyMigrationIfNoChunk()
+{
+	// Hosts don't call setStateInformation for a project that saved no state, so by the first
+	// editor or save nothing restored means there is nothing but the legacy values to show
+	if (! sessionChunkRestored.load() && ! legacySessionMigrationPending.exchange (true))
+		SAIRYNE_LOG_INFO("Session state: no session chunk restored, migrating legacy keys on first read");
+}
+
+void SairyneAudioProcessor::saveUiValue (const juce::String& key, const juce::String& value)
+{
+	if (! isSessionKey (key))
+	{
+		// An empty value clears the key, as it does for session keys
+		if (value.isEmpty())
+			getStore().removeValue (key);
+		else
+			getStore().setValue (key, value);
+		return;
+	}
+
+	{
+		const juce::ScopedLock sl (legacyMigrationLock);
+		legacyKeysMigrated.addIfNotAlreadyThere (key);
+	}
+
+	// Empty removes the section
+	if (sessionState.setValue (key, value))
+		sessionStateChanged();
+}
+
+void SairyneAudioProcessor::sessionStateChanged()
+{
+	// Lets the host know the project has unsaved changes
+	updateHostDisplay (ChangeDetails().withNonParameterStateChanged (true));
+}
+
+void SairyneAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+	startLegacyMigrationIfNoChunk();
+
+	// Saved now, or the project would keep nothing until its editor is opened
+	if (legacySessionMigrationPending.load())
+		for (const auto& key : getUiSessionKeys())
+			migrateLegacyValue (key);
+
+	// Only sections changed since the last call are re-encoded
+	sessionState.writeTo (destData);
+}
+
+void SairyneAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+	if (! sessionState.restoreFrom (data, sizeInBytes))
+	{
+		// Not a session chunk (older versions saved nothing): offer the legacy values instead
+		legacySessionMigrationPending = true;
+		SAIRYNE_LOG_INFO("setStateInformation: no session chunk (" + juce::String(sizeInBytes) + " bytes), migrating legacy keys on first read");
+		return;
+	}
+
+	sessionChunkRestored = true;
+	legacySessionMigrationPending = false;
+
+	SAIRYNE_LOG_DEBUG("setStateInformation: " + juce::String(sessionState.getNumSections()) + " sections, "
+		+ juce::String(sizeInBytes) + " bytes");
+
+	// The only section needed right away; the rest stay compressed until the UI asks
+	const auto role = sessionState.getValue (trackRoleSection);
+	{
+		const juce::ScopedLock lock (trackInfoLock);
+		trackRoleOverride = role == "master" || role == "track" ? role : juce::String();
+	}
+
+	updateMasterRole();
+}
+
+void SairyneAudioProcessor::editorAttached()
+{
+	startLegacyMigrationIfNoChunk();
+
+	if (++openEditors == 1)
+		analysisEngine.setDetailed (true);
+}
+
+void SairyneAudioProcessor::editorDetached()
+{
+	if (--openEditors == 0)
+		analysisEngine.setDetailed (false);
+}
+
+void SairyneAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+	analysisEngine.prepare (sampleRate, samplesPerBlock, getTotalNumInputChannels());
+	SAIRYNE_LOG_INFO("prepareToPlay: " + juce::String(sampleRate) + " Hz, block " + juce::String(samplesPerBlock));
+
+   #if SAIRYNE_PERSISTENT_WEBVIEW
+	// Plugin scans rarely get this far, so this is a real session: load the UI before it is opened
+	if (! std::exchange (webViewPrewarmRequested, true))
+		juce::MessageManager::callAsync ([cache = webViewCache] { cache->prewarm (&createWebBrowser); });
+   #endif
+}
+
+void SairyneAudioProcessor::releaseResources()
+{
+	analysisEngine.release();
+}
+
+void SairyneAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+	// Audio thread: no allocation, locking or logging below this line
+	const SairyneRealtimeScope realtimeScope;
+	juce::ScopedNoDenormals noDenormals;
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+
+	for (auto ch = getTotalNumInputChannels(); ch < getTotalNumOutputChannels(); ++ch)
+		buffer.clear (ch, 0, buffer.getNumSamples());
+
+	// Pass-through: the analysis engine only copies the block into its FIFO
+	analysisEngine.pushAudio (buffer);
+
+	// Lock-free; cost against this block's real-time budget
+	services->getDiagnostics().recordProcessBlock (startTicks, buffer.getNumSamples(), getSampleRate());
 }
 
 std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
+{
+	const auto openStartedMs = juce::Time::getMillisecondCounterHiRes();
+
+   #if SAIRYNE_PERSISTENT_WEBVIEW
+	auto view = webViewCache->take (&createWebBrowser);
+	view->attachTo (this, openStartedMs);
+	return std::make_unique<SairyneWebViewHolder> (std::move (view));
+   #else
+	auto view = createWebBrowser();
+	if (view != nullptr)
+		view->attachTo (this, openStartedMs);
+	return view;
+   #endif
+}
+
+std::unique_ptr<SairyneWebView> SairyneAudioProcessor::createWebBrowser()
 {
 #if JUCE_MODULE_AVAILABLE_juce_gui_extra
 	// Local subclass to expose current URL via Component::getName() on navigation
-	struct HashReportingWebBrowser : public juce::WebBrowserComponent
+	struct HashReportingWebBrowser : public SairyneWebView
 	{
-		HashReportingWebBrowser(SairyneAudioProcessor* processor)
-			: juce::WebBrowserComponent (juce::WebBrowserComponent::Options{}
+		explicit HashReportingWebBrowser (const juce::String& appPageUrl)
+			: SairyneWebView (withPersistence (juce::WebBrowserComponent::Options{})
 				.withNativeIntegrationEnabled()
+				.withResourceProvider ([this](const juce::String& path) { return getResource (path); })
 				.withEventListener (juce::Identifier("sairyneResize"),
 					[this](const juce::var& payload) { handleNativeResizeEvent (payload); })
 				.withEventListener (juce::Identifier("openUrl"),
@@ -83,12 +285,174 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 					[this](const juce::var& payload) { handleSaveDataEvent (payload); })
 				.withEventListener (juce::Identifier("loadData"),
 					[this](const juce::var& payload) { handleLoadDataEvent (payload); })
+				.withEventListener (juce::Identifier("rpc"),
+					[this](const juce::var& payload) { handleRpcEvent (payload); })
+				.withEventListener (juce::Identifier("rpcTimings"),
+					[this](const juce::var& payload) { handleRpcTimingsEvent (payload); })
+				.withEventListener (juce::Identifier("analysisSubscribe"),
+					[this](const juce::var& payload) { if (analysisStreamer != nullptr) analysisStreamer->handleSubscribe (payload); })
+				.withEventListener (juce::Identifier("analysisAck"),
+					[this](const juce::var& payload) { if (analysisStreamer != nullptr) analysisStreamer->handleAck (payload); })
+				.withEventListener (juce::Identifier("analyzeStems"),
+					[this](const juce::var& payload) { if (stemAnalysis != nullptr) stemAnalysis->handleAnalyzeRequest (payload); })
+				.withEventListener (juce::Identifier("cancelStemAnalysis"),
+					[this](const juce::var&) { if (stemAnalysis != nullptr) stemAnalysis->handleCancel(); })
+				.withEventListener (juce::Identifier("diagnosticsSubscribe"),
+					[this](const juce::var& payload) { if (diagnosticsStreamer != nullptr) diagnosticsStreamer->handleSubscribe (payload); })
+				.withEventListener (juce::Identifier("setTrackRole"),
+					[this](const juce::var& payload) { handleSetTrackRoleEvent (payload); })
+				.withEventListener (juce::Identifier("sairyneUiReady"),
+					[this](const juce::var&) { pageInteractive = true; reportInteractive(); })
 				.withUserScript (getHelperScript()))
-			, audioProcessor(processor)
+			, pageUrl (appPageUrl)
+		{
+			stemAnalysis = std::make_unique<StemAnalysisRunner> (*this);
+		}
+
+		~HashReportingWebBrowser() override
+		{
+			attachTo (nullptr, 0.0);
+		}
+
+		void attachTo (SairyneAudioProcessor* processor, double openStartedMs) override
+		{
+			if (processor == audioProcessor)
+				return;
+
+			diagnosticsStreamer.reset();
+			maskingStreamer.reset();
+			analysisStreamer.reset();
+
+			if (audioProcessor != nullptr)
+				audioProcessor->editorDetached();
+
+			audioProcessor = processor;
+			++projectGeneration;
+
+			// Before the state below is read: it may switch on the legacy migration
+			if (audioProcessor != nullptr)
+				audioProcessor->editorAttached();
+
+			// A page that already has its state (ready answered) still shows the previous
+			// project's, or none if it was pre-warmed: replace it before the page saves anything
+			if (pageHasInitialState)
+				deliverSessionState();
+
+			if (audioProcessor != nullptr)
+			{
+				analysisStreamer = std::make_unique<AnalysisFrameStreamer> (audioProcessor->getAnalysisEngine(), *this, services->getDiagnostics());
+				maskingStreamer = std::make_unique<CrossTrackMaskingStreamer> (*audioProcessor, *this);
+				diagnosticsStreamer = std::make_unique<DiagnosticsStreamer> (*services, *this);
+
+				openedAtMs = openStartedMs;
+				openedWarm = pageInteractive;
+				interactiveReported = false;
+
+				// Re-parented with the page already up: interactive once the editor is on screen
+				if (pageInteractive)
+					juce::MessageManager::callAsync ([safe = juce::Component::SafePointer<HashReportingWebBrowser> (this)]
+					{
+						if (safe != nullptr)
+							safe->reportInteractive();
+					});
+			}
+		}
+
+		static juce::WebBrowserComponent::Options withPersistence (juce::WebBrowserComponent::Options options)
+		{
+		   #if SAIRYNE_PERSISTENT_WEBVIEW
+			// Parked between editors: without this JUCE blanks the page while it is hidden
+			return options.withKeepPageLoadedWhenBrowserIsHidden();
+		   #else
+			return options;
+		   #endif
+		}
+
+		std::optional<juce::WebBrowserComponent::Resource> getResource (const juce::String& path)
+		{
+			// The root is the wrapper page; it frames the app page from the same origin
+			if (path.isEmpty() || path == "/")
+			{
+				const auto html = getWrapperHtml (SairyneUiBundle::entryPage);
+				const auto* bytes = reinterpret_cast<const std::byte*> (html.toRawUTF8());
+				return juce::WebBrowserComponent::Resource { { bytes, bytes + html.getNumBytesAsUTF8() }, "text/html" };
+			}
+
+			return uiBundle->getResource (path);
+		}
+
+		// Open-to-interactive: from createWebViewComponent() to the framed page's load event
+		// (for a re-parented page that was already loaded, to the next message loop turn)
+		void reportInteractive()
+		{
+			if (audioProcessor == nullptr || interactiveReported)
+				return;
+
+			interactiveReported = true;
+			const auto elapsedMs = juce::Time::getMillisecondCounterHiRes() - openedAtMs;
+			auto& diagnostics = services->getDiagnostics();
+			(openedWarm ? diagnostics.editorOpenWarmMicros : diagnostics.editorOpenColdMicros).record (elapsedMs * 1000.0);
+			SAIRYNE_LOG_INFO("UI open-to-interactive: " + juce::String(elapsedMs, 1) + " ms ("
+				+ (openedWarm ? "warm" : "cold") + ", " + (uiBundle->isAvailable() ? "bundled" : "hosted") + ")");
+		}
+
+		// Project-scoped keys go through the processor (host session). A parked page has no
+		// project, so it only reaches the shared store and never the project-scoped keys.
+		void saveValue (const juce::String& key, const juce::String& value)
+		{
+			if (audioProcessor != nullptr)
+				audioProcessor->saveUiValue (key, value);
+			else if (SairyneAudioProcessor::isSessionKey (key))
+				SAIRYNE_LOG_DEBUG("saveValue: dropped project key " + key + " (no project attached)");
+			else if (value.isEmpty())
+				services->getStore().removeValue (key);
+			else
+				services->getStore().setValue (key, value);
+		}
+
+		juce::String loadValue (const juce::String& key)
+		{
+			if (audioProcessor != nullptr)
+				return audioProcessor->loadUiValue (key);
+
+			return SairyneAudioProcessor::isSessionKey (key) ? juce::String() : services->getStore().getValue (key);
+		}
+
+		SairyneAudioProcessor* audioProcessor = nullptr;
+		// Bumped whenever the page changes project; the page echoes it in storage.set, and
+		// project-scoped keys from an older generation are dropped
+		int projectGeneration = 0;
+		bool pageHasInitialState = false;
+		juce::SharedResourcePointer<SairyneServices> services;
+		juce::SharedResourcePointer<SairyneUiBundle> uiBundle;
+		// The framed app page (bundled or hosted)
+		const juce::String pageUrl;
+		bool pageInteractive = false;
+		bool interactiveReported = false;
+		bool openedWarm = false;
+		double openedAtMs = 0.0;
+
+		// Spectrum/meter frames -> page (binary, throttled, coalesced)
+		std::unique_ptr<AnalysisFrameStreamer> analysisStreamer;
+		// Offline stem/channel analysis ("Analyzing your channels...")
+		std::unique_ptr<StemAnalysisRunner> stemAnalysis;
+		// Master only: cross-track masking from the other instances' summaries
+		std::unique_ptr<CrossTrackMaskingStreamer> maskingStreamer;
+		// Performance counters, while the page asks for them
+		std::unique_ptr<DiagnosticsStreamer> diagnosticsStreamer;
+
+		void handleSetTrackRoleEvent (const juce::var& payload)
 		{
+			juce::String role;
+
+			if (const auto* obj = payload.getDynamicObject())
+				role = obj->getProperty("role").toString();
+			else if (payload.isString())
+				role = payload.toString();
+
+			if (audioProcessor != nullptr)
+				audioProcessor->setTrackRole (role.trim().toLowerCase());
 		}
-		
-		SairyneAudioProcessor* audioProcessor;
 
 		static juce::String getHelperScript()
 		{
@@ -466,8 +830,7 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			// Log all juce:// URLs for debugging
 			if (newURL.startsWithIgnoreCase("juce://"))
 			{
-				DBG("pageAboutToLoad -> juce:// URL: " + newURL.substring(0, 200));
-				juce::Logger::writeToLog("pageAboutToLoad -> juce:// URL: " + newURL.substring(0, 200));
+				SAIRYNE_LOG_DEBUG("pageAboutToLoad -> juce:// URL: " + newURL.substring(0, 100));
 				
 				// Handle juce:// messages
 				if (handleJuceMessage(newURL))
@@ -475,25 +838,14 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 					return false; // Don't navigate, we handled it
 				}
 			}
-			// Check if page finished loading (main site URL)
-			else if (newURL.startsWithIgnoreCase("https://sairyne-ai.vercel.app/embed-chat.html"))
+			// The app asks for its saved state itself (the "ready" call) once its bridge is up
+			else if (newURL.startsWithIgnoreCase(pageUrl))
 			{
-				DBG("pageAboutToLoad -> Main page loaded, injecting saved data");
-				juce::Logger::writeToLog("pageAboutToLoad -> Main page loaded, injecting saved data");
-				
-				// Inject saved data after a short delay to ensure page is ready
-				juce::MessageManager::callAsync([this]()
-				{
-					juce::MessageManager::callAsync([this]()
-					{
-						injectSavedData();
-					});
-				});
+				SAIRYNE_LOG_DEBUG("pageAboutToLoad -> app page: " + newURL.substring(0, 100));
 			}
 			else
 			{
-				DBG("pageAboutToLoad -> " + newURL.substring(0, 100));
-				juce::Logger::writeToLog("pageAboutToLoad -> " + newURL.substring(0, 100));
+				SAIRYNE_LOG_DEBUG("pageAboutToLoad -> " + newURL.substring(0, 100));
 			}
 
 			setName(newURL);
@@ -505,14 +857,12 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			// Log all sairyne:// URLs for debugging
 			if (newURL.startsWithIgnoreCase("sairyne://"))
 			{
-				DBG("newWindowAttemptingToLoad -> sairyne:// URL: " + newURL.substring(0, 200));
-				juce::Logger::writeToLog("newWindowAttemptingToLoad -> sairyne:// URL: " + newURL.substring(0, 200));
+				SAIRYNE_LOG_DEBUG("newWindowAttemptingToLoad -> sairyne:// URL: " + newURL.substring(0, 100));
 			}
 			// Also handle juce:// URLs here (fallback if pageAboutToLoad doesn't catch them)
 			else if (newURL.startsWithIgnoreCase("juce://"))
 			{
-				DBG("newWindowAttemptingToLoad -> juce:// URL: " + newURL.substring(0, 200));
-				juce::Logger::writeToLog("newWindowAttemptingToLoad -> juce:// URL: " + newURL.substring(0, 200));
+				SAIRYNE_LOG_DEBUG("newWindowAttemptingToLoad -> juce:// URL: " + newURL.substring(0, 100));
 				
 				// Try to handle it
 				if (handleJuceMessage(newURL))
@@ -522,8 +872,7 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			}
 			else
 			{
-				DBG("newWindowAttemptingToLoad -> " + newURL);
-				juce::Logger::writeToLog("newWindowAttemptingToLoad -> " + newURL);
+				SAIRYNE_LOG_DEBUG("newWindowAttemptingToLoad -> " + newURL.substring(0, 100));
 			}
 			
 			// If it's a custom scheme, handle it
@@ -533,11 +882,9 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			// If it's a regular HTTP/HTTPS URL, open it in system browser
 			if (newURL.startsWithIgnoreCase("http://") || newURL.startsWithIgnoreCase("https://"))
 			{
-				DBG("newWindowAttemptingToLoad: Opening URL in system browser: " + newURL);
-				juce::Logger::writeToLog("newWindowAttemptingToLoad: Opening URL in system browser: " + newURL);
+				SAIRYNE_LOG_DEBUG("newWindowAttemptingToLoad: Opening URL in system browser: " + newURL);
 				bool success = juce::URL(newURL).launchInDefaultBrowser();
-				DBG("newWindowAttemptingToLoad: launchInDefaultBrowser returned: " + juce::String(success ? "true" : "false"));
-				juce::Logger::writeToLog("newWindowAttemptingToLoad: launchInDefaultBrowser returned: " + juce::String(success ? "true" : "false"));
+				SAIRYNE_LOG_DEBUG("newWindowAttemptingToLoad: launchInDefaultBrowser returned: " + juce::String(success ? "true" : "false"));
 			}
 		}
 
@@ -564,263 +911,69 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			}
 
 			const juce::String marker = "sairyne://expanded=" + juce::String (expanded ? "1" : "0");
-			DBG("nativeEvent sairyneResize -> " + marker);
-			juce::Logger::writeToLog("nativeEvent sairyneResize -> " + marker);
+			SAIRYNE_LOG_DEBUG("nativeEvent sairyneResize -> " + marker);
 			setName (marker);
 		}
 
 		// Unified handler for juce:// messages (replaces all sairyne:// handling)
 		bool handleJuceMessage (const juce::String& newURL)
 		{
-			DBG("handleJuceMessage: " + newURL.substring(0, 200));
-			juce::Logger::writeToLog("handleJuceMessage: " + newURL.substring(0, 200));
+			SAIRYNE_LOG_DEBUG("handleJuceMessage: " + newURL.substring(0, 100));
 			
 			if (!newURL.startsWithIgnoreCase("juce://"))
 				return false;
 			
-			if (audioProcessor == nullptr)
-			{
-				DBG("handleJuceMessage: audioProcessor is null!");
-				juce::Logger::writeToLog("handleJuceMessage: audioProcessor is null!");
-				return false;
-			}
-			
 			// Handle juce://save?key=...&value=...
 			if (newURL.startsWithIgnoreCase("juce://save"))
 			{
-				DBG("handleJuceMessage: detected juce://save");
-				juce::Logger::writeToLog("handleJuceMessage: detected juce://save");
-				juce::Logger::writeToLog("handleJuceMessage: Full URL (first 500 chars): " + newURL.substring(0, 500));
+				SAIRYNE_LOG_DEBUG("handleJuceMessage: detected juce://save");
+				
+				const auto key = SairyneBridgeCodec::getQueryParameter(newURL, "key");
+				const auto value = SairyneBridgeCodec::getQueryParameter(newURL, "value");
 				
-				auto urlStart = newURL.indexOfChar('?');
-				if (urlStart > 0)
+				if (key.isNotEmpty() && value.isNotEmpty())
 				{
-					auto query = newURL.substring(urlStart + 1);
-					juce::String key, value;
-					
-					// Parse query string: key=...&value=...
-					auto keyStart = query.indexOf("key=");
-					auto valueStart = query.indexOf("value=");
-					
-					if (keyStart >= 0 && valueStart >= 0)
-					{
-						// Extract key (between key= and & or end)
-						auto keySubstring = query.substring(keyStart + 4);
-						auto keyEnd = keySubstring.indexOfChar('&');
-						if (keyEnd < 0)
-							key = keySubstring;
-						else
-							key = keySubstring.substring(0, keyEnd);
-						
-						// Extract value (everything after value=)
-						value = query.substring(valueStart + 6);
-						
-						// URL decode
-						key = key.replace("%3A", ":").replace("%2F", "/").replace("%3F", "?").replace("%3D", "=").replace("%26", "&").replace("%25", "%").replace("+", " ").replace("%20", " ").replace("%0A", "\n").replace("%0D", "\r").replace("%2B", "+");
-						value = value.replace("%3A", ":").replace("%2F", "/").replace("%3F", "?").replace("%3D", "=").replace("%26", "&").replace("%25", "%").replace("+", " ").replace("%20", " ").replace("%0A", "\n").replace("%0D", "\r").replace("%2B", "+");
-						
-						if (key.isNotEmpty() && value.isNotEmpty())
-						{
-							DBG("handleJuceMessage: Processing save for key: " + key + ", value length: " + juce::String(value.length()));
-							juce::Logger::writeToLog("handleJuceMessage: Processing save for key: " + key + ", value length: " + juce::String(value.length()));
-							juce::Logger::writeToLog("handleJuceMessage: Value preview (first 200 chars): " + value.substring(0, 200));
-							
-							// Special handling for persistUsers and persistProjects
-							if (key == "sairyne_users")
-							{
-								DBG("handleJuceMessage: 🎯 PERSISTUSERS CALLED - saving users data");
-								juce::Logger::writeToLog("handleJuceMessage: 🎯 PERSISTUSERS CALLED - saving users data");
-								juce::Logger::writeToLog("handleJuceMessage: Users JSON length: " + juce::String(value.length()));
-							}
-							else if (key == "sairyne_projects")
-							{
-								DBG("handleJuceMessage: 🎯 PERSISTPROJECTS CALLED - saving projects data");
-								juce::Logger::writeToLog("handleJuceMessage: 🎯 PERSISTPROJECTS CALLED - saving projects data");
-								juce::Logger::writeToLog("handleJuceMessage: Projects JSON length: " + juce::String(value.length()));
-							}
-							
-							auto* props = audioProcessor->getPropertiesFile();
-							if (props != nullptr)
-							{
-								DBG("handleJuceMessage: PropertiesFile is available, setting value...");
-								juce::Logger::writeToLog("handleJuceMessage: PropertiesFile is available, setting value...");
-								
-								props->setValue(key, value);
-								props->saveIfNeeded();
-								
-								// Force flush to disk
-								props->save();
-								
-								// Verify the save worked
-								auto savedValue = props->getValue(key, "");
-								if (savedValue == value)
-								{
-									DBG("handleJuceMessage: ✅ Saved and verified data: " + key + " = " + value.substring(0, 50) + "...");
-									juce::Logger::writeToLog("handleJuceMessage: ✅ Saved and verified data: " + key + " = " + value.substring(0, 50) + "...");
-									juce::Logger::writeToLog("handleJuceMessage: PropertiesFile path: " + props->getFile().getFullPathName());
-									
-									// Special confirmation for persistUsers/persistProjects
-									if (key == "sairyne_users")
-									{
-										DBG("handleJuceMessage: ✅✅✅ PERSISTUSERS SUCCESS - users data saved to PropertiesFile");
-										juce::Logger::writeToLog("handleJuceMessage: ✅✅✅ PERSISTUSERS SUCCESS - users data saved to PropertiesFile");
-									}
-									else if (key == "sairyne_projects")
-									{
-										DBG("handleJuceMessage: ✅✅✅ PERSISTPROJECTS SUCCESS - projects data saved to PropertiesFile");
-										juce::Logger::writeToLog("handleJuceMessage: ✅✅✅ PERSISTPROJECTS SUCCESS - projects data saved to PropertiesFile");
-									}
-								}
-								else
-								{
-									DBG("handleJuceMessage: ⚠️ Save failed - value mismatch for key: " + key);
-									juce::Logger::writeToLog("handleJuceMessage: ⚠️ Save failed - value mismatch for key: " + key);
-									juce::Logger::writeToLog("handleJuceMessage: Expected length: " + juce::String(value.length()) + ", saved length: " + juce::String(savedValue.length()));
-								}
-								return true;
-							}
-							else
-							{
-								DBG("handleJuceMessage: PropertiesFile is null!");
-								juce::Logger::writeToLog("handleJuceMessage: PropertiesFile is null!");
-							}
-						}
-					}
+					// In-memory write; the store journals it on its writer thread
+					saveValue(key, value);
+					SAIRYNE_LOG_DEBUG("handleJuceMessage: ✅ Saved data: " + key + " (" + juce::String(value.length()) + " chars)");
 				}
 				return true;
 			}
 			// Handle juce://load?key=...
 			else if (newURL.startsWithIgnoreCase("juce://load"))
 			{
-				DBG("handleJuceMessage: detected juce://load");
-				juce::Logger::writeToLog("handleJuceMessage: detected juce://load");
+				SAIRYNE_LOG_DEBUG("handleJuceMessage: detected juce://load");
 				
-				auto urlStart = newURL.indexOfChar('?');
-				if (urlStart > 0)
+				const auto key = SairyneBridgeCodec::getQueryParameter(newURL, "key");
+				if (key.isNotEmpty())
 				{
-					auto query = newURL.substring(urlStart + 1);
-					juce::String key;
-					
-					if (query.startsWithIgnoreCase("key="))
-					{
-						key = query.substring(4);
-						// URL decode
-						key = key.replace("%3A", ":").replace("%2F", "/").replace("%3F", "?").replace("%3D", "=").replace("%26", "&").replace("%25", "%").replace("+", " ");
-						
-						auto* props = audioProcessor->getPropertiesFile();
-						if (props != nullptr)
-						{
-							auto value = props->getValue(key, "");
-							if (value.isNotEmpty())
-							{
-								// Send data back to WebView via postMessage to iframe
-								juce::String escapedValue = value.replace("\\", "\\\\").replace("'", "\\'").replace("\n", "\\n").replace("\r", "\\r");
-								juce::String escapedKey = key.replace("\\", "\\\\").replace("'", "\\'").replace("\n", "\\n").replace("\r", "\\r");
-								
-								// Try both iframe postMessage and direct call (with retry)
-								juce::String jsCode = 
-									"(function() {"
-									"  var key = '" + escapedKey + "';"
-									"  var val = '" + escapedValue + "';"
-									"  var iframe = document.getElementById('sairyne_iframe');"
-									"  if (iframe && iframe.contentWindow) {"
-									"    try {"
-									"      iframe.contentWindow.postMessage({"
-									"        type: 'juce_data_loaded',"
-									"        key: key,"
-									"        value: val"
-									"      }, '*');"
-									"      console.log('[JUCE Load] ✅ Sent juce_data_loaded to iframe:', key);"
-									"    } catch(e) {"
-									"      console.error('[JUCE Load] ❌ Error sending postMessage:', e);"
-									"    }"
-									"  }"
-									"  if (window.onJuceDataLoaded && typeof window.onJuceDataLoaded === 'function') {"
-									"    try {"
-									"      window.onJuceDataLoaded(key, val);"
-									"      console.log('[JUCE Load] ✅ Called window.onJuceDataLoaded directly:', key);"
-									"    } catch(e) {"
-									"      console.error('[JUCE Load] ❌ Error calling onJuceDataLoaded:', e);"
-									"    }"
-									"  }"
-									"})();";
-								
-								evaluateJavascript(jsCode);
-								DBG("handleJuceMessage: Loaded data: " + key + " = " + value.substring(0, 50) + "...");
-								juce::Logger::writeToLog("handleJuceMessage: Loaded data: " + key + " = " + value.substring(0, 50) + "...");
-							}
-							else
-							{
-								// Send null/empty response to clear pending flag and prevent infinite loops
-								juce::String escapedKey = key.replace("\\", "\\\\").replace("'", "\\'").replace("\n", "\\n").replace("\r", "\\r");
-								juce::String jsCode = "if (window.onJuceDataLoaded && typeof window.onJuceDataLoaded === 'function') { window.onJuceDataLoaded('" + escapedKey + "', ''); }";
-								evaluateJavascript(jsCode);
-								DBG("handleJuceMessage: No data found for key: " + key + " (sent empty response to clear pending flag)");
-								juce::Logger::writeToLog("handleJuceMessage: No data found for key: " + key + " (sent empty response to clear pending flag)");
-							}
-						}
-					}
+					// Empty value for a missing key, so the page stops waiting for it
+					const auto value = loadValue(key);
+					deliverDataLoaded(key, value);
+					SAIRYNE_LOG_DEBUG("handleJuceMessage: Loaded data: " + key + " (" + juce::String(value.length()) + " chars)");
 				}
 				return true;
 			}
 			// Handle juce://debug?message=... (for debugging)
 			else if (newURL.startsWithIgnoreCase("juce://debug"))
 			{
-				DBG("handleJuceMessage: detected juce://debug");
-				juce::Logger::writeToLog("handleJuceMessage: detected juce://debug");
+				SAIRYNE_LOG_DEBUG("handleJuceMessage: detected juce://debug");
 				
-				auto urlStart = newURL.indexOfChar('?');
-				if (urlStart > 0)
-				{
-					auto query = newURL.substring(urlStart + 1);
-					if (query.startsWithIgnoreCase("message="))
-					{
-						auto message = query.substring(8);
-						// URL decode
-						message = message.replace("%3A", ":").replace("%2F", "/").replace("%3F", "?").replace("%3D", "=").replace("%26", "&").replace("%25", "%").replace("+", " ").replace("%20", " ").replace("%0A", "\n").replace("%0D", "\r").replace("%2B", "+");
-						DBG("handleJuceMessage: DEBUG MESSAGE: " + message);
-						juce::Logger::writeToLog("handleJuceMessage: DEBUG MESSAGE: " + message);
-					}
-				}
+				const auto message = SairyneBridgeCodec::getQueryParameter(newURL, "message");
+				if (message.isNotEmpty())
+					SAIRYNE_LOG_DEBUG("handleJuceMessage: DEBUG MESSAGE: " + message);
 				return true;
 			}
 			// Handle juce://open_url?url=...
 			else if (newURL.startsWithIgnoreCase("juce://open_url"))
 			{
-				DBG("handleJuceMessage: detected juce://open_url");
-				juce::Logger::writeToLog("handleJuceMessage: detected juce://open_url");
+				SAIRYNE_LOG_DEBUG("handleJuceMessage: detected juce://open_url");
 				
-				auto urlStart = newURL.indexOfChar('?');
-				if (urlStart > 0)
+				const auto url = SairyneBridgeCodec::getQueryParameter(newURL, "url");
+				if (url.isNotEmpty())
 				{
-					auto query = newURL.substring(urlStart + 1);
-					if (query.startsWithIgnoreCase("url="))
-					{
-						auto url = query.substring(4);
-						// URL decode
-						juce::String decodedUrl;
-						for (int i = 0; i < url.length(); ++i)
-						{
-							if (url[i] == '%' && i + 2 < url.length())
-							{
-								auto hex = url.substring(i + 1, 2);
-								auto code = hex.getHexValue32();
-								if (code > 0)
-								{
-									decodedUrl += juce::String::charToString((char)code);
-									i += 2;
-									continue;
-								}
-							}
-							decodedUrl += url[i];
-						}
-						if (decodedUrl.isEmpty())
-							decodedUrl = url;
-						
-						bool success = juce::URL(decodedUrl).launchInDefaultBrowser();
-						DBG("handleJuceMessage: Opening URL in system browser: " + decodedUrl + " (success: " + juce::String(success ? "true" : "false") + ")");
-						juce::Logger::writeToLog("handleJuceMessage: Opening URL in system browser: " + decodedUrl + " (success: " + juce::String(success ? "true" : "false") + ")");
-					}
+					bool success = juce::URL(url).launchInDefaultBrowser();
+					SAIRYNE_LOG_DEBUG("handleJuceMessage: Opening URL in system browser: " + url + " (success: " + juce::String(success ? "true" : "false") + ")");
 				}
 				return true;
 			}
@@ -828,116 +981,185 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			return false;
 		}
 
-		// Inject all saved data into WebView on plugin startup
-		void injectSavedData()
+		// Keys the app needs before its first screen: answered in one go by the "ready" call
+		static juce::StringArray getInitialKeys()
 		{
-			if (audioProcessor == nullptr)
-			{
-				DBG("injectSavedData: audioProcessor is null!");
-				juce::Logger::writeToLog("injectSavedData: audioProcessor is null!");
-				return;
-			}
-			
-			auto* props = audioProcessor->getPropertiesFile();
-			if (props == nullptr)
+			return { "sairyne_users",
+			         "sairyne_current_user",
+			         "sairyne_access_token",
+			         "sairyne_projects",
+			         "sairyne_selected_project",
+			         // Chat/UI persistence
+			         "sairyne_functional_chat_state_v1",
+			         // Smoke-test key to verify save pipeline works end-to-end
+			         "sairyne_smoke_test" };
+		}
+
+		// Native -> page messages are scripts calling the wrapper's __sairyneDeliver(), which posts
+		// them to the framed app. Built in one buffer with the bridge codecs: values are not
+		// re-escaped per pattern, and unlike emitEventIfBrowserIsVisible() nothing is encoded twice
+		// or dropped while the page is parked (which would strand a pending call).
+		static void beginPageMessage (juce::MemoryOutputStream& script, const char* type)
+		{
+			script << "window.__sairyneDeliver && window.__sairyneDeliver({\"type\":\"" << type << "\"";
+		}
+
+		void deliverToPage (juce::MemoryOutputStream& script)
+		{
+			script << "});";
+			evaluateJavascript (script.toUTF8());
+		}
+
+		void deliverDataLoaded (const juce::String& key, const juce::String& value)
+		{
+			juce::MemoryOutputStream script;
+			beginPageMessage (script, "juce_data_loaded");
+			script << ",\"key\":";
+			SairyneBridgeCodec::writeJsonString (script, key);
+			script << ",\"value\":";
+			SairyneBridgeCodec::writeJsonString (script, value);
+			deliverToPage (script);
+		}
+
+		// The attached project's keys for a page that is already up: { type: 'juce_session',
+		// generation, values } with every project-scoped key, empty where this project has none
+		void deliverSessionState()
+		{
+			const auto keys = audioProcessor != nullptr ? audioProcessor->getUiSessionKeys()
+			                                            : juce::StringArray { "sairyne_functional_chat_state_v1", "sairyne_selected_project" };
+
+			juce::MemoryOutputStream script;
+			beginPageMessage (script, "juce_session");
+			script << ",\"generation\":" << projectGeneration << ",\"values\":{";
+
+			for (int i = 0; i < keys.size(); ++i)
 			{
-				DBG("injectSavedData: PropertiesFile is null!");
-				juce::Logger::writeToLog("injectSavedData: PropertiesFile is null!");
-				return;
+				if (i > 0)
+					script << ",";
+
+				SairyneBridgeCodec::writeJsonString (script, keys[i]);
+				script << ":";
+				SairyneBridgeCodec::writeJsonString (script, loadValue (keys[i]));
 			}
-			
-			// Get all keys we care about
-			juce::StringArray keys;
-			keys.add("sairyne_users");
-			keys.add("sairyne_current_user");
-			keys.add("sairyne_access_token");
-			keys.add("sairyne_projects");
-			keys.add("sairyne_selected_project");
-			// Also inject chat/UI persistence keys
-			keys.add("sairyne_functional_chat_state_v1");
-			// Smoke-test key to verify save pipeline works end-to-end
-			keys.add("sairyne_smoke_test");
-			
-			// Build JSON object with all saved data
-			juce::String json = "{";
-			bool first = true;
-			int injectedCount = 0;
-			for (const auto& key : keys)
+
+			script << "}";
+			deliverToPage (script);
+			SAIRYNE_LOG_DEBUG("Session state re-delivered to the page (generation " + juce::String(projectGeneration) + ")");
+		}
+
+		// Page -> native calls, { id, method, params }; each gets exactly one
+		// { type: 'juce_rpc_result', id, result } or { ..., error } back:
+		//   ready        {}                                -> { values: { key: value }, generation }  (initial keys)
+		//   storage.get  { keys: [...] }                    -> { values: { key: value } }  (missing keys left out)
+		//   storage.set  { entries: { k: v }, generation }  -> { saved: count }  (empty v clears k)
+		void handleRpcEvent (const juce::var& request)
+		{
+			const auto startTicks = juce::Time::getHighResolutionTicks();
+			const auto& id = request["id"];
+			const auto method = request["method"].toString();
+			const auto& params = request["params"];
+
+			juce::MemoryOutputStream script;
+			beginPageMessage (script, "juce_rpc_result");
+			script << ",\"id\":" << juce::JSON::toString (id, true);
+
+			auto writeValues = [&] (const juce::StringArray& keys)
 			{
-				auto value = props->getValue(key, "");
-				if (value.isNotEmpty())
+				script << ",\"result\":{\"values\":{";
+				bool first = true;
+
+				for (const auto& key : keys)
 				{
-					if (!first)
-						json += ",";
+					const auto value = loadValue (key);
+					if (value.isEmpty())
+						continue;
+
+					if (! first)
+						script << ",";
 					first = false;
-					injectedCount++;
-					
-					// Escape JSON properly (handle all special characters)
-					juce::String escapedKey = key.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n").replace("\r", "\\r").replace("\t", "\\t");
-					juce::String escapedValue = value.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n").replace("\r", "\\r").replace("\t", "\\t");
-					json += "\"" + escapedKey + "\":\"" + escapedValue + "\"";
-					
-					DBG("injectSavedData: Adding key: " + key + " (value length: " + juce::String(value.length()) + ")");
-					juce::Logger::writeToLog("injectSavedData: Adding key: " + key + " (value length: " + juce::String(value.length()) + ")");
+
+					SairyneBridgeCodec::writeJsonString (script, key);
+					script << ":";
+					SairyneBridgeCodec::writeJsonString (script, value);
 				}
-				else
+
+				script << "}";
+			};
+
+			if (method == "ready")
+			{
+				writeValues (getInitialKeys());
+				script << ",\"generation\":" << projectGeneration << "}";
+				pageHasInitialState = true;
+			}
+			else if (method == "storage.get")
+			{
+				juce::StringArray keys;
+				if (const auto* list = params["keys"].getArray())
+					for (const auto& key : *list)
+						keys.add (key.toString());
+
+				writeValues (keys);
+				script << "}";
+			}
+			else if (method == "storage.set")
+			{
+				// Sent before the page saw the current project's juce_session: its project-scoped
+				// values belong to the project it was showing
+				const auto& generation = params["generation"];
+				const bool otherProject = ! generation.isVoid() && (int) generation != projectGeneration;
+
+				int saved = 0;
+				if (auto* entries = params["entries"].getDynamicObject())
 				{
-					DBG("injectSavedData: Key not found or empty: " + key);
-					juce::Logger::writeToLog("injectSavedData: Key not found or empty: " + key);
+					for (const auto& entry : entries->getProperties())
+					{
+						// An empty value clears the key
+						const auto value = entry.value.toString();
+
+						if (otherProject && SairyneAudioProcessor::isSessionKey (entry.name.toString()))
+						{
+							SAIRYNE_LOG_DEBUG("storage.set: dropped " + entry.name.toString() + " from generation " + generation.toString());
+							continue;
+						}
+
+						saveValue (entry.name.toString(), value);
+						++saved;
+					}
 				}
+
+				script << ",\"result\":{\"saved\":" << saved << "}";
 			}
-			json += "}";
-			
-			if (injectedCount > 0) // Only inject if we have data
+			else
 			{
-				// Inject into iframe via postMessage with retry logic (iframe may not be ready yet)
-				juce::String jsCode = 
-					"(function() {"
-					"  var jsonData = " + json + ";"
-					"  var attempts = 0;"
-					"  var maxAttempts = 10;"
-					"  function tryInject() {"
-					"    attempts++;"
-					"    var iframe = document.getElementById('sairyne_iframe');"
-					"    if (iframe && iframe.contentWindow) {"
-					"      try {"
-					"        iframe.contentWindow.postMessage({"
-					"          type: 'juce_init',"
-					"          data: jsonData"
-					"        }, '*');"
-					"        console.log('[JUCE Inject] ✅ Sent juce_init to iframe, attempt ' + attempts);"
-					"      } catch(e) {"
-					"        console.error('[JUCE Inject] ❌ Error sending postMessage:', e);"
-					"      }"
-					"    } else if (attempts < maxAttempts) {"
-					"      setTimeout(tryInject, 200);"
-					"    } else {"
-					"      console.warn('[JUCE Inject] ⚠️ Iframe not found after ' + maxAttempts + ' attempts');"
-					"    }"
-					"    // Also try direct call (fallback)"
-					"    if (window.onJuceInit && typeof window.onJuceInit === 'function') {"
-					"      try {"
-					"        window.onJuceInit(jsonData);"
-					"        console.log('[JUCE Inject] ✅ Called window.onJuceInit directly');"
-					"      } catch(e) {"
-					"        console.error('[JUCE Inject] ❌ Error calling onJuceInit:', e);"
-					"      }"
-					"    }"
-					"  }"
-					"  tryInject();"
-					"})();";
-				
-				DBG("injectSavedData: Executing JavaScript with " + juce::String(injectedCount) + " keys");
-				juce::Logger::writeToLog("injectSavedData: Executing JavaScript with " + juce::String(injectedCount) + " keys");
-				juce::Logger::writeToLog("injectSavedData: JSON length: " + juce::String(json.length()));
-				evaluateJavascript(jsCode);
-				DBG("injectSavedData: Injected " + juce::String(injectedCount) + " keys (with retry logic)");
-				juce::Logger::writeToLog("injectSavedData: Injected " + juce::String(injectedCount) + " keys (with retry logic)");
+				SAIRYNE_LOG_WARN("rpc: unknown method '" + method + "'");
+				script << ",\"error\":";
+				SairyneBridgeCodec::writeJsonString (script, "unknown method: " + method);
 			}
-			else
+
+			SAIRYNE_LOG_DEBUG("rpc " + method + " #" + id.toString() + " -> " + juce::String((int) script.getDataSize()) + " bytes");
+			deliverToPage (script);
+			services->getDiagnostics().bridgeRpcHandlerMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+		}
+
+		// { roundTripMicros: [...] }: the page's own callJuce() timings, send -> result delivered,
+		// which include both WebView hops that the handler time above can't see
+		void handleRpcTimingsEvent (const juce::var& payload)
+		{
+			constexpr int maxSamplesPerReport = 256;
+			const auto* samples = payload["roundTripMicros"].getArray();
+
+			if (samples == nullptr)
+				return;
+
+			auto& histogram = services->getDiagnostics().bridgeRpcRoundTripMicros;
+
+			for (int i = 0; i < juce::jmin (samples->size(), maxSamplesPerReport); ++i)
 			{
-				DBG("injectSavedData: No saved data to inject");
-				juce::Logger::writeToLog("injectSavedData: No saved data to inject");
+				const auto sample = (*samples)[i];
+
+				if (sample.isDouble() || sample.isInt() || sample.isInt64())
+					histogram.record (juce::jmax (0.0, (double) sample));
 			}
 		}
 
@@ -954,41 +1176,14 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			// Handle sairyne://open_url?url=... (fallback for open_url)
 			if (newURL.startsWithIgnoreCase("sairyne://open_url"))
 			{
-				DBG("handleCustomScheme: detected sairyne://open_url");
-				juce::Logger::writeToLog("handleCustomScheme: detected sairyne://open_url");
+				SAIRYNE_LOG_DEBUG("handleCustomScheme: detected sairyne://open_url");
 				
-				auto urlStart = newURL.indexOfChar('?');
-				if (urlStart > 0)
+				const auto url = SairyneBridgeCodec::getQueryParameter(newURL, "url");
+				if (url.isNotEmpty())
 				{
-					auto query = newURL.substring(urlStart + 1);
-					if (query.startsWithIgnoreCase("url="))
-					{
-						auto url = query.substring(4);
-						// URL decode
-						juce::String decodedUrl;
-						for (int i = 0; i < url.length(); ++i)
-						{
-							if (url[i] == '%' && i + 2 < url.length())
-							{
-								auto hex = url.substring(i + 1, 2);
-								auto code = hex.getHexValue32();
-								if (code > 0)
-								{
-									decodedUrl += juce::String::charToString((char)code);
-									i += 2;
-									continue;
-								}
-							}
-							decodedUrl += url[i];
-						}
-						if (decodedUrl.isEmpty())
-							decodedUrl = url;
-						
-						bool success = juce::URL(decodedUrl).launchInDefaultBrowser();
-						DBG("handleCustomScheme: Opening URL in system browser: " + decodedUrl + " (success: " + juce::String(success ? "true" : "false") + ")");
-						juce::Logger::writeToLog("handleCustomScheme: Opening URL in system browser: " + decodedUrl + " (success: " + juce::String(success ? "true" : "false") + ")");
-						return true; // Handled
-					}
+					bool success = juce::URL(url).launchInDefaultBrowser();
+					SAIRYNE_LOG_DEBUG("handleCustomScheme: Opening URL in system browser: " + url + " (success: " + juce::String(success ? "true" : "false") + ")");
+					return true; // Handled
 				}
 			}
 			
@@ -997,65 +1192,48 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 
 		void handleOpenUrlEvent (const juce::var& payload)
 		{
-			DBG("handleOpenUrlEvent called");
-			juce::Logger::writeToLog("handleOpenUrlEvent called");
+			SAIRYNE_LOG_DEBUG("handleOpenUrlEvent called");
 			
 			juce::String url;
 			
 			if (payload.isString())
 			{
 				url = payload.toString();
-				DBG("handleOpenUrlEvent: payload is string: " + url);
-				juce::Logger::writeToLog("handleOpenUrlEvent: payload is string: " + url);
+				SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: payload is string: " + url);
 			}
 			else if (const auto* obj = payload.getDynamicObject())
 			{
-				DBG("handleOpenUrlEvent: payload is object");
-				juce::Logger::writeToLog("handleOpenUrlEvent: payload is object");
+				SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: payload is object");
 				if (obj->hasProperty("url"))
 				{
 					url = obj->getProperty("url").toString();
-					DBG("handleOpenUrlEvent: extracted url from object: " + url);
-					juce::Logger::writeToLog("handleOpenUrlEvent: extracted url from object: " + url);
+					SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: extracted url from object: " + url);
 				}
 				else
 				{
-					DBG("handleOpenUrlEvent: object has no 'url' property");
-					juce::Logger::writeToLog("handleOpenUrlEvent: object has no 'url' property");
+					SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: object has no 'url' property");
 				}
 			}
 			else
 			{
-				DBG("handleOpenUrlEvent: payload is neither string nor object");
-				juce::Logger::writeToLog("handleOpenUrlEvent: payload is neither string nor object");
+				SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: payload is neither string nor object");
 			}
 			
 			if (url.isNotEmpty())
 			{
-				DBG("handleOpenUrlEvent: Opening URL in system browser: " + url);
-				juce::Logger::writeToLog("handleOpenUrlEvent: Opening URL in system browser: " + url);
+				SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: Opening URL in system browser: " + url);
 				bool success = juce::URL(url).launchInDefaultBrowser();
-				DBG("handleOpenUrlEvent: launchInDefaultBrowser returned: " + juce::String(success ? "true" : "false"));
-				juce::Logger::writeToLog("handleOpenUrlEvent: launchInDefaultBrowser returned: " + juce::String(success ? "true" : "false"));
+				SAIRYNE_LOG_DEBUG("handleOpenUrlEvent: launchInDefaultBrowser returned: " + juce::String(success ? "true" : "false"));
 			}
 			else
 			{
-				DBG("handleOpenUrlEvent: URL is empty, cannot open");
-				juce::Logger::writeToLog("handleOpenUrlEvent: URL is empty, cannot open");
+				SAIRYNE_LOG_WARN("handleOpenUrlEvent: URL is empty, cannot open");
 			}
 		}
 
 		void handleSaveDataEvent (const juce::var& payload)
 		{
-			DBG("handleSaveDataEvent called");
-			juce::Logger::writeToLog("handleSaveDataEvent called");
-			
-			if (audioProcessor == nullptr)
-			{
-				DBG("handleSaveDataEvent: audioProcessor is null!");
-				juce::Logger::writeToLog("handleSaveDataEvent: audioProcessor is null!");
-				return;
-			}
+			SAIRYNE_LOG_DEBUG("handleSaveDataEvent called");
 			
 			juce::String key, value;
 			
@@ -1082,39 +1260,18 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			
 			if (key.isNotEmpty() && value.isNotEmpty())
 			{
-				auto* props = audioProcessor->getPropertiesFile();
-				if (props != nullptr)
-				{
-					props->setValue(key, value);
-					props->saveIfNeeded();
-					DBG("handleSaveDataEvent: Saved data: " + key + " = " + value.substring(0, 50) + "...");
-					juce::Logger::writeToLog("handleSaveDataEvent: Saved data: " + key + " = " + value.substring(0, 50) + "...");
-					juce::Logger::writeToLog("handleSaveDataEvent: PropertiesFile path: " + props->getFile().getFullPathName());
-				}
-				else
-				{
-					DBG("handleSaveDataEvent: PropertiesFile is null!");
-					juce::Logger::writeToLog("handleSaveDataEvent: PropertiesFile is null!");
-				}
+				saveValue(key, value);
+				SAIRYNE_LOG_DEBUG("handleSaveDataEvent: Saved data: " + key + " (" + juce::String(value.length()) + " chars)");
 			}
 			else
 			{
-				DBG("handleSaveDataEvent: key or value is empty! key=" + key + ", value length=" + juce::String(value.length()));
-				juce::Logger::writeToLog("handleSaveDataEvent: key or value is empty! key=" + key + ", value length=" + juce::String(value.length()));
+				SAIRYNE_LOG_DEBUG("handleSaveDataEvent: key or value is empty! key=" + key + ", value length=" + juce::String(value.length()));
 			}
 		}
 
 		void handleLoadDataEvent (const juce::var& payload)
 		{
-			DBG("handleLoadDataEvent called");
-			juce::Logger::writeToLog("handleLoadDataEvent called");
-			
-			if (audioProcessor == nullptr)
-			{
-				DBG("handleLoadDataEvent: audioProcessor is null!");
-				juce::Logger::writeToLog("handleLoadDataEvent: audioProcessor is null!");
-				return;
-			}
+			SAIRYNE_LOG_DEBUG("handleLoadDataEvent called");
 			
 			juce::String key;
 			
@@ -1130,38 +1287,29 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 			
 			if (key.isNotEmpty())
 			{
-				auto* props = audioProcessor->getPropertiesFile();
-				if (props != nullptr)
+				auto value = loadValue(key);
+				if (value.isNotEmpty())
 				{
-					auto value = props->getValue(key, "");
-					if (value.isNotEmpty())
-					{
-						// Send data back via custom scheme (will be handled by wrapper script)
-						juce::String encodedKey = key.replace("%", "%25").replace("&", "%26").replace("=", "%3D").replace("+", "%2B").replace(" ", "%20").replace("\n", "%0A").replace("\r", "%0D");
-						juce::String encodedValue = value.replace("%", "%25").replace("&", "%26").replace("=", "%3D").replace("+", "%2B").replace(" ", "%20").replace("\n", "%0A").replace("\r", "%0D");
-						juce::String callbackUrl = "sairyne://data_loaded?key=" + encodedKey + "&value=" + encodedValue;
-						setName(callbackUrl);
-						DBG("handleLoadDataEvent: Loaded data: " + key + " = " + value.substring(0, 50) + "...");
-						juce::Logger::writeToLog("handleLoadDataEvent: Loaded data: " + key + " = " + value.substring(0, 50) + "...");
-					}
-					else
-					{
-						DBG("handleLoadDataEvent: No data found for key: " + key);
-						juce::Logger::writeToLog("handleLoadDataEvent: No data found for key: " + key);
-					}
+					deliverDataLoaded(key, value);
+					SAIRYNE_LOG_DEBUG("handleLoadDataEvent: Loaded data: " + key + " (" + juce::String(value.length()) + " chars)");
+				}
+				else
+				{
+					SAIRYNE_LOG_DEBUG("handleLoadDataEvent: No data found for key: " + key);
 				}
 			}
 			else
 			{
-				DBG("handleLoadDataEvent: key is empty!");
-				juce::Logger::writeToLog("handleLoadDataEvent: key is empty!");
+				SAIRYNE_LOG_DEBUG("handleLoadDataEvent: key is empty!");
 			}
 		}
-	};
-	auto* browser = new HashReportingWebBrowser(this);
-	// Wrapper HTML to remove outer scroll, fill view, and avoid bounce/white edges
-    const juce::String siteUrl = "https://sairyne-ai.vercel.app/embed-chat.html";
-    const auto wrapper = juce::String(
+
+	public:
+		// Wrapper HTML to remove outer scroll, fill view, and avoid bounce/white edges.
+		// siteUrl is the framed app page: the hosted one, or entryPage relative to the bundle root.
+		static juce::String getWrapperHtml (const juce::String& siteUrl)
+		{
+			return juce::String(
 		"<!DOCTYPE html><html><head>"
 		"<meta charset='utf-8'/>"
 		"<meta name='viewport' content='width=device-width, initial-scale=1, maximum-scale=1, viewport-fit=cover'/>"
@@ -1199,16 +1347,56 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 		"   } } catch(_){ }"
 		"   try { location.hash = '#expanded=' + flag; } catch(_){ }"
 		" }"
-		" // Handle data_loaded callback from JUCE"
-		" function handleDataLoaded(key, value) {"
-		"   try {"
-		"     if (window.onJuceDataLoaded && typeof window.onJuceDataLoaded === 'function') {"
-		"       window.onJuceDataLoaded(key, value);"
-		"     }"
-		"   } catch(err) {"
-		"     console.error('[Wrapper] Error in onJuceDataLoaded:', err);"
+		" // Analysis frames: decode the base64 bands once into a Float32Array, transfer the"
+		" // buffer to the iframe (no copy) and ack after the next paint so C++ can throttle"
+		" function attachAnalysisStream(retries) {"
+		"   var b = window.__JUCE__ && window.__JUCE__.backend;"
+		"   if (!b || typeof b.addEventListener !== 'function') {"
+		"     if (retries > 0) setTimeout(function(){ attachAnalysisStream(retries - 1); }, 150);"
+		"     return;"
 		"   }"
+		"   b.addEventListener('analysisFrame', function(frame) {"
+		"     var seq = frame ? frame.seq : 0;"
+		"     try {"
+		"       var raw = atob(frame.bands || '');"
+		"       var bytes = new Uint8Array(raw.length);"
+		"       for (var i = 0; i < raw.length; i++) bytes[i] = raw.charCodeAt(i);"
+		"       frame.bands = new Float32Array(bytes.buffer);"
+		"       var f = document.getElementById('sairyne_iframe');"
+		"       if (f && f.contentWindow) f.contentWindow.postMessage({ type: 'juce_analysis_frame', frame: frame }, '*', [bytes.buffer]);"
+		"     } catch(err) { console.error('[Wrapper] ❌ analysisFrame failed:', err); }"
+		"     requestAnimationFrame(function(){ try { b.emitEvent('analysisAck', { seq: seq }); } catch(_){ } });"
+		"   });"
+		"   b.addEventListener('crossTrackMasking', function(data) {"
+		"     try {"
+		"       var f = document.getElementById('sairyne_iframe');"
+		"       if (f && f.contentWindow) f.contentWindow.postMessage({ type: 'juce_cross_track_masking', payload: data }, '*');"
+		"     } catch(err) { console.error('[Wrapper] ❌ crossTrackMasking failed:', err); }"
+		"   });"
+		"   b.addEventListener('diagnostics', function(data) {"
+		"     try {"
+		"       var f = document.getElementById('sairyne_iframe');"
+		"       if (f && f.contentWindow) f.contentWindow.postMessage({ type: 'juce_diagnostics', payload: data }, '*');"
+		"     } catch(err) { console.error('[Wrapper] ❌ diagnostics failed:', err); }"
+		"   });"
+		"   // Stem analysis: progress / result / error go to the iframe as-is"
+		"   ['stemAnalysisProgress', 'stemAnalysisResult', 'stemAnalysisError'].forEach(function(name) {"
+		"     b.addEventListener(name, function(data) {"
+		"       try {"
+		"         var f = document.getElementById('sairyne_iframe');"
+		"         if (f && f.contentWindow) f.contentWindow.postMessage({ type: 'juce_stem_analysis', event: name, payload: data }, '*');"
+		"       } catch(err) { console.error('[Wrapper] ❌ ' + name + ' failed:', err); }"
+		"     });"
+		"   });"
 		" }"
+		" attachAnalysisStream(40);"
+		" // Native -> app messages (RPC results, loaded values): C++ calls this through evaluateJavascript"
+		" window.__sairyneDeliver = function(message) {"
+		"   try {"
+		"     var f = document.getElementById('sairyne_iframe');"
+		"     if (f && f.contentWindow) f.contentWindow.postMessage(message, '*');"
+		"   } catch(err) { console.error('[Wrapper] ❌ deliver failed:', err); }"
+		" };"
 		" window.addEventListener('message', function(e){"
         "   var payload = e.data;"
 		"   console.log('[Wrapper] 📨 Message event received, payload type:', typeof payload);"
@@ -1220,6 +1408,18 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 		"       var data = payload.payload;"
 		"       console.log('[Wrapper] 📥 Received JUCE_DATA:', command, data ? JSON.stringify(data).substring(0, 200) : 'no payload');"
 		"       "
+		"       // RPC call ({ id, method, params }); the one reply comes back through __sairyneDeliver"
+		"       if (command === 'rpc' && data) {"
+		"         try {"
+		"           if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"             window.__JUCE__.backend.emitEvent('rpc', data);"
+		"             return;"
+		"           }"
+		"         } catch(err) { console.error('[Wrapper] ❌ emitEvent(rpc) failed:', err); }"
+		"         window.__sairyneDeliver({ type: 'juce_rpc_result', id: data.id, error: 'native bridge unavailable' });"
+		"         return;"
+		"       }"
+		"       "
 		"       // Handle save_data command"
 		"       if (command === 'save_data' && data && data.key && data.value) {"
 		"         console.log('[Wrapper] 💾 Processing save_data for key:', data.key, 'value length:', data.value.length);"
@@ -1267,6 +1467,56 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
 		"         return;"
 		"       }"
 		"       "
+		"       // Handle analysis_subscribe command ({ fps: 30 } to start, { fps: 0 } to stop)"
+		"       if (command === 'analysis_subscribe') {"
+		"         try {"
+		"           if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"             window.__JUCE__.backend.emitEvent('analysisSubscribe', data || {});"
+		"           }"
+		"         } catch(err) { console.error('[Wrapper] ❌ emitEvent(analysisSubscribe) failed:', err); }"
+		"         return;"
+		"       }"
+		"       "
+		"       // Handle diagnostics_subscribe ({ intervalMs: 1000 } to start, { intervalMs: 0 } to stop)"
+		"       if (command === 'diagnostics_subscribe') {"
+		"         try {"
+		"           if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"             window.__JUCE__.backend.emitEvent('diagnosticsSubscribe', data || {});"
+		"           }"
+		"         } catch(err) { console.error('[Wrapper] ❌ emitEvent(diagnosticsSubscribe) failed:', err); }"
+		"         return;"
+		"       }"
+		"       "
+		"       // Handle rpc_timings ({ roundTripMicros: [...] }, measured by the app's callJuce)"
+		"       if (command === 'rpc_timings') {"
+		"         try {"
+		"           if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"             window.__JUCE__.backend.emitEvent('rpcTimings', data || {});"
+		"           }"
+		"         } catch(err) { console.error('[Wrapper] ❌ emitEvent(rpcTimings) failed:', err); }"
+		"         return;"
+		"       }"
+		"       "
+		"       // Handle set_track_role ({ role: 'master' | 'track' | 'auto' })"
+		"       if (command === 'set_track_role') {"
+		"         try {"
+		"           if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"             window.__JUCE__.backend.emitEvent('setTrackRole', data || {});"
+		"           }"
+		"         } catch(err) { console.error('[Wrapper] ❌ emitEvent(setTrackRole) failed:', err); }"
+		"         return;"
+		"       }"
+		"       "
+		"       // Handle analyze_stems ({ files: [...] } / { folder } / {} to pick) and cancel_stem_analysis"
+		"       if (command === 'analyze_stems' || command === 'cancel_stem_analysis') {"
+		"         try {"
+		"           if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"             window.__JUCE__.backend.emitEvent(command === 'analyze_stems' ? 'analyzeStems' : 'cancelStemAnalysis', data || {});"
+		"           }"
+		"         } catch(err) { console.error('[Wrapper] ❌ emitEvent(' + command + ') failed:', err); }"
+		"         return;"
+		"       }"
+		"       "
 		"       console.log('[Wrapper] ⚠️ Unknown JUCE_DATA command:', command);"
 		"       return;"
 		"     }"
@@ -1331,59 +1581,15 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
         "     reportFlag(flag);"
         "   }"
 		" });"
-		" // Monitor for data_loaded via pageAboutToLoad"
-		" // When JUCE calls setName() with sairyne://data_loaded, it triggers pageAboutToLoad"
-		" // We'll intercept this and send to iframe via postMessage"
-		" var lastDataLoadedUrl = '';"
-		" function checkForDataLoaded() {"
-		"   try {"
-		"     // Check if current URL contains data_loaded (setName triggers pageAboutToLoad)"
-		"     var currentUrl = window.location.href || '';"
-		"     if (currentUrl !== lastDataLoadedUrl && currentUrl.indexOf('sairyne://data_loaded') >= 0) {"
-		"       lastDataLoadedUrl = currentUrl;"
-		"       var urlParts = currentUrl.split('?');"
-		"       if (urlParts.length > 1) {"
-		"         var params = urlParts[1];"
-		"         var keyMatch = params.match(/key=([^&]+)/);"
-		"         var valueMatch = params.match(/value=(.+)$/);"
-		"         if (keyMatch && valueMatch) {"
-		"           var key = decodeURIComponent(keyMatch[1]);"
-		"           var value = decodeURIComponent(valueMatch[1]);"
-		"           // Send to iframe"
-		"           var iframe = document.getElementById('sairyne_iframe');"
-		"           if (iframe && iframe.contentWindow) {"
-		"             iframe.contentWindow.postMessage({ type: 'juce_data_loaded', key: key, value: value }, '*');"
-		"           }"
-		"         }"
-		"       }"
-		"     }"
-		"   } catch(err) {"
-		"     console.error('[Wrapper] Error checking data_loaded:', err);"
-		"   }"
-		" }"
-		" // Check periodically (pageAboutToLoad may not trigger location.href change)"
-		" setInterval(checkForDataLoaded, 100);"
-		" // Also listen for postMessage from JUCE (if sent directly)"
-		" window.addEventListener('message', function(e) {"
-		"   try {"
-		"     if (e.data && e.data.type === 'juce_data_loaded') {"
-		"       var key = e.data.key || '';"
-		"       var value = e.data.value || '';"
-		"       if (key && value) {"
-		"         // Forward to iframe"
-		"         var iframe = document.getElementById('sairyne_iframe');"
-		"         if (iframe && iframe.contentWindow) {"
-		"           iframe.contentWindow.postMessage({ type: 'juce_data_loaded', key: key, value: value }, '*');"
-		"         }"
-		"       }"
-		"     }"
-		"   } catch(err) {"
-		"     console.error('[Wrapper] Error handling juce_data_loaded:', err);"
-		"   }"
-		" });"
         " var f = document.getElementById('sairyne_iframe');"
         " if(!f) return;"
         " f.addEventListener('load', function(){"
+		"  // Open-to-interactive timing (native side measures from editor open)"
+		"  try {"
+		"    if (window.__JUCE__ && window.__JUCE__.backend && typeof window.__JUCE__.backend.emitEvent === 'function') {"
+		"      window.__JUCE__.backend.emitEvent('sairyneUiReady', { sinceNavigationMs: Math.round(performance.now()) });"
+		"    }"
+		"  } catch(e) {}"
         "  try{"
         "    var d = f.contentDocument || f.contentWindow.document;"
         "    if(!d) return;"
@@ -1425,31 +1631,43 @@ std::unique_ptr<juce::Component> SairyneAudioProcessor::createWebViewComponent()
         "})();"
         "</script>"
 		"</body></html>");
-	// Use base64 data URL to avoid percent-encoded artifacts displaying as text
-	const char* utf8 = wrapper.toRawUTF8();
-	juce::String b64 = juce::Base64::toBase64(utf8, (size_t) wrapper.getNumBytesAsUTF8());
-	browser->setName("data:text/html"); // initial
+		}
+	};
+
+	// Bundled UI: the wrapper comes from the resource provider root and frames the app page
+	// from the same origin, so opening the editor needs no network. Otherwise the hosted app.
+	const juce::SharedResourcePointer<SairyneUiBundle> uiBundle;
+	const bool bundled = uiBundle->isAvailable();
+	const juce::String rootUrl = juce::WebBrowserComponent::getResourceProviderRoot();
+	const juce::String hostedUrl = "https://sairyne-ai.vercel.app/embed-chat.html";
+
+	auto browser = std::make_unique<HashReportingWebBrowser> (bundled ? rootUrl + SairyneUiBundle::entryPage : hostedUrl);
+	browser->setName(bundled ? rootUrl : juce::String("data:text/html")); // initial
 	try
 	{
-		browser->goToURL("data:text/html;charset=utf-8;base64," + b64);
+		if (bundled)
+		{
+			browser->goToURL(rootUrl);
+		}
+		else
+		{
+			// Use base64 data URL to avoid percent-encoded artifacts displaying as text
+			const auto wrapper = HashReportingWebBrowser::getWrapperHtml(hostedUrl);
+			const char* utf8 = wrapper.toRawUTF8();
+			juce::String b64 = juce::Base64::toBase64(utf8, (size_t) wrapper.getNumBytesAsUTF8());
+			browser->goToURL("data:text/html;charset=utf-8;base64," + b64);
+		}
 	}
 	catch (const std::exception& ex)
 	{
-		juce::Logger::writeToLog("WebView goToURL exception: " + juce::String(ex.what()));
+		SAIRYNE_LOG_ERROR("WebView goToURL exception: " + juce::String(ex.what()));
 	}
 	catch (...)
 	{
-		juce::Logger::writeToLog("WebView goToURL exception: unknown");
+		SAIRYNE_LOG_ERROR("WebView goToURL exception: unknown");
 	}
-	return std::unique_ptr<juce::Component>(browser);
+	return browser;
 #else
 	jassertfalse; return {};
 #endif
 }
-
-// ========= Обязательная фабрика JUCE =========
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-	DBG("createPluginFilter(): constructing processor");
-	return new SairyneAudioProcessor();
-}
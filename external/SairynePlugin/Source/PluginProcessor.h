@@ -2,6 +2,11 @@
 #include <JuceHeader.h>
 #include <memory>
 #include <atomic>
+#include "AnalysisEngine.h"
+#include "SairyneServices.h"
+#include "SairyneSessionState.h"
+#include "SairyneUiBundle.h"
+#include "SairyneWebView.h"
 
 class SairyneAudioProcessor : public juce::AudioProcessor
 {
@@ -10,9 +15,10 @@ public:
     ~SairyneAudioProcessor() override;
 
     //=== JUCE обязательные функции ===//
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override {}
-    void releaseResources() override {}
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override {}
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void updateTrackProperties (const TrackProperties& properties) override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -29,25 +35,84 @@ public:
     const juce::String getProgramName (int) override { return {}; }
     void changeProgramName (int, const juce::String&) override {}
 
-    void getStateInformation (juce::MemoryBlock&) override {}
-    void setStateInformation (const void*, int) override {}
+    // Project-scoped state in the host session (see SairyneSessionState)
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
 
-    // WebView factory (decouples editor from implementation)
+    // WebView factory (decouples editor from implementation). With SAIRYNE_PERSISTENT_WEBVIEW
+    // this is a holder around a process-wide browser that is re-parented on every open.
     std::unique_ptr<juce::Component> createWebViewComponent();
 
     // Soft guard overlay API
     bool shouldShowMasterOverlay() const { return masterOverlay; }
     void dismissMasterOverlayForThisSession() { masterOverlay = false; }
     
-    // PropertiesFile access (for storage)
-    juce::PropertiesFile* getPropertiesFile();
+    // Journaled key-value storage for the web UI (shared by all instances)
+    SairyneStore& getStore() { return services->getStore(); }
+
+    // Web UI storage. Project-scoped keys (chat state, selected project, "sairyne_session_*")
+    // live only in the host session; everything else in the shared store. A project saved
+    // before session state existed (or whose host restores no chunk at all) adopts its keys
+    // from the shared store once, on first read or the first getStateInformation.
+    static bool isSessionKey (const juce::String& key);
+    // The fixed project-scoped keys plus every "sairyne_session_*" key this project has
+    juce::StringArray getUiSessionKeys() const;
+    juce::String loadUiValue (const juce::String& key);
+    void saveUiValue (const juce::String& key, const juce::String& value);
+
+    // Legacy XML settings (only read to migrate into the store)
+    juce::PropertiesFile* getPropertiesFile() { return &services->getLegacyProperties(); }
+
+    // Per-track analysis (spectrum, LUFS, RMS/peak, correlation, track-bus summary)
+    SairyneAnalysisEngine& getAnalysisEngine() { return analysisEngine; }
+    SairyneTrackBus& getTrackBus() { return services->getTrackBus(); }
+
+    // Master = aggregates the other instances' summaries for cross-track masking.
+    // Detected from the host's track name unless the UI sets "master" / "track" ("auto" resets).
+    bool isMasterTrack() const noexcept { return masterTrack.load (std::memory_order_relaxed); }
+    void setTrackRole (const juce::String& role);
+
+    // Message thread; the WebView calls these so only an instance with an open UI pays for it
+    void editorAttached();
+    void editorDetached();
 
 private:
-    // One-instance (soft) and overlay flag
-    static std::atomic<int> liveInstances;
+    void updateMasterRole();
+    void sessionStateChanged();
+    void startLegacyMigrationIfNoChunk();
+    bool migrateLegacyValue (const juce::String& key);
+    static std::unique_ptr<SairyneWebView> createWebBrowser();
+
     bool masterOverlay = true;
-    std::unique_ptr<juce::FileLogger> fileLogger;
-    
-    // PropertiesFile for persistent storage (fallback if localStorage doesn't work)
-    std::unique_ptr<juce::PropertiesFile> propertiesFile;
+
+    // Logger, store, analysis thread and track bus, shared by every instance in the process.
+    // Declared first so it outlives everything below that uses it.
+    juce::SharedResourcePointer<SairyneServices> services;
+
+    SairyneAnalysisEngine analysisEngine { services->getAnalysisScheduler(), services->getTrackBus() };
+
+    // Embedded web UI; keeps inflated assets between editor opens
+    juce::SharedResourcePointer<SairyneUiBundle> uiBundle;
+
+   #if SAIRYNE_PERSISTENT_WEBVIEW
+    // Parked WebView between editors; the first prepareToPlay pre-warms it
+    juce::SharedResourcePointer<SairyneWebViewCache> webViewCache;
+    bool webViewPrewarmRequested = false;
+   #endif
+
+    static constexpr const char* trackRoleSection = "track_role";
+    SairyneSessionState sessionState;
+
+    // Set when the host restored a chunk that isn't ours (a project saved before session state),
+    // or restored none by the time the first editor opens or the state is first saved
+    std::atomic<bool> legacySessionMigrationPending { false };
+    std::atomic<bool> sessionChunkRestored { false };
+    juce::CriticalSection legacyMigrationLock;  // getStateInformation may run off the message thread
+    juce::StringArray legacyKeysMigrated;
+
+    juce::CriticalSection trackInfoLock;
+    juce::String hostTrackName;
+    juce::String trackRoleOverride;             // "", "master" or "track"
+    std::atomic<bool> masterTrack { false };
+    int openEditors = 0;
 };
\ No newline at end of file
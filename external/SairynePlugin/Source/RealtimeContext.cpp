@@ -0,0 +1,136 @@
+#include "RealtimeContext.h"
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace
+{
+	thread_local bool currentThreadIsRealtime = false;
+	std::atomic<int> allocationViolations { 0 };
+	std::atomic<int> blockingCallViolations { 0 };
+
+	void recordViolation (std::atomic<int>& counter) noexcept
+	{
+		counter.fetch_add (1, std::memory_order_relaxed);
+
+		// A debug jassert logs, and logging allocates: leave the scope while it runs so that
+		// allocation is neither counted nor re-enters the checked allocator
+		const bool wasRealtime = std::exchange (currentThreadIsRealtime, false);
+		jassertfalse;
+		currentThreadIsRealtime = wasRealtime;
+	}
+}
+
+SairyneRealtimeScope::SairyneRealtimeScope() noexcept
+	: wasRealtime (currentThreadIsRealtime)
+{
+	currentThreadIsRealtime = true;
+}
+
+SairyneRealtimeScope::~SairyneRealtimeScope() noexcept
+{
+	currentThreadIsRealtime = wasRealtime;
+}
+
+bool SairyneRealtimeScope::isCurrentThreadRealtime() noexcept
+{
+	return currentThreadIsRealtime;
+}
+
+int SairyneRealtimeScope::getAllocationViolationCount() noexcept
+{
+	return allocationViolations.load (std::memory_order_relaxed);
+}
+
+int SairyneRealtimeScope::getBlockingCallViolationCount() noexcept
+{
+	return blockingCallViolations.load (std::memory_order_relaxed);
+}
+
+void SairyneRealtimeScope::reportBlockingCall() noexcept
+{
+	recordViolation (blockingCallViolations);
+}
+
+#if SAIRYNE_DETECT_REALTIME_ALLOCATIONS
+// Debug/benchmark builds only: replace the global allocator so any heap allocation
+// made while a SairyneRealtimeScope is active is counted (and trips a debugger).
+static void* sairyneCheckedAlloc (std::size_t size) noexcept
+{
+	if (currentThreadIsRealtime)
+		recordViolation (allocationViolations); // heap allocation on the audio thread
+
+	return std::malloc (size == 0 ? 1 : size);
+}
+
+static void* sairyneCheckedAlignedAlloc (std::size_t size, std::align_val_t alignment) noexcept
+{
+	if (currentThreadIsRealtime)
+		recordViolation (allocationViolations);
+
+	const auto align = juce::jmax (sizeof (void*), (std::size_t) alignment);
+	size = size == 0 ? 1 : size;
+
+   #if JUCE_WINDOWS
+	return _aligned_malloc (size, align);
+   #else
+	void* p = nullptr;
+	return posix_memalign (&p, align, size) == 0 ? p : nullptr;
+   #endif
+}
+
+static void sairyneAlignedFree (void* p) noexcept
+{
+   #if JUCE_WINDOWS
+	_aligned_free (p);
+   #else
+	std::free (p);
+   #endif
+}
+
+void* operator new (std::size_t size)
+{
+	if (auto* p = sairyneCheckedAlloc (size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size)
+{
+	if (auto* p = sairyneCheckedAlloc (size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+	if (auto* p = sairyneCheckedAlignedAlloc (size, alignment))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment)
+{
+	if (auto* p = sairyneCheckedAlignedAlloc (size, alignment))
+		return p;
+	throw std::bad_alloc();
+}
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept    { return sairyneCheckedAlloc (size); }
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept  { return sairyneCheckedAlloc (size); }
+void operator delete (void* p) noexcept                                   { std::free (p); }
+void operator delete[] (void* p) noexcept                                 { std::free (p); }
+void operator delete (void* p, std::size_t) noexcept                      { std::free (p); }
+void operator delete[] (void* p, std::size_t) noexcept                    { std::free (p); }
+void operator delete (void* p, const std::nothrow_t&) noexcept            { std::free (p); }
+void operator delete[] (void* p, const std::nothrow_t&) noexcept          { std::free (p); }
+
+void* operator new (std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept    { return sairyneCheckedAlignedAlloc (size, a); }
+void* operator new[] (std::size_t size, std::align_val_t a, const std::nothrow_t&) noexcept  { return sairyneCheckedAlignedAlloc (size, a); }
+void operator delete (void* p, std::align_val_t) noexcept                                      { sairyneAlignedFree (p); }
+void operator delete[] (void* p, std::align_val_t) noexcept                                    { sairyneAlignedFree (p); }
+void operator delete (void* p, std::size_t, std::align_val_t) noexcept                         { sairyneAlignedFree (p); }
+void operator delete[] (void* p, std::size_t, std::align_val_t) noexcept                       { sairyneAlignedFree (p); }
+void operator delete (void* p, std::align_val_t, const std::nothrow_t&) noexcept               { sairyneAlignedFree (p); }
+void operator delete[] (void* p, std::align_val_t, const std::nothrow_t&) noexcept             { sairyneAlignedFree (p); }
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+
+// Marks the current thread as a real-time (audio) thread for the lifetime of the scope.
+// Code that may allocate, lock or log asserts it is not running inside such a scope.
+class SairyneRealtimeScope
+{
+public:
+    SairyneRealtimeScope() noexcept;
+    ~SairyneRealtimeScope() noexcept;
+
+    static bool isCurrentThreadRealtime() noexcept;
+
+    // Heap allocations made inside a realtime scope. Only counted when the
+    // process is built with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1.
+    static int getAllocationViolationCount() noexcept;
+
+    // Locks, logging and other blocking calls that reached SAIRYNE_ASSERT_NOT_REALTIME
+    // (or the logger) inside a realtime scope. Counted in every build.
+    static int getBlockingCallViolationCount() noexcept;
+
+    // Counts a blocking call and trips the debugger. The assertion runs with the realtime
+    // flag cleared, so its own allocations are not counted (or recursed into).
+    static void reportBlockingCall() noexcept;
+
+private:
+    bool wasRealtime;
+
+    JUCE_DECLARE_NON_COPYABLE (SairyneRealtimeScope)
+};
+
+#ifndef SAIRYNE_DETECT_REALTIME_ALLOCATIONS
+ #define SAIRYNE_DETECT_REALTIME_ALLOCATIONS 0
+#endif
+
+#define SAIRYNE_ASSERT_NOT_REALTIME() \
+    do { if (SairyneRealtimeScope::isCurrentThreadRealtime()) SairyneRealtimeScope::reportBlockingCall(); } while (false)
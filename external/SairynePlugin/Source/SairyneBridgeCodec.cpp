@@ -0,0 +1,138 @@
+#include "SairyneBridgeCodec.h"
+#include <cstring>
+
+namespace
+{
+	int hexValue (char c) noexcept
+	{
+		if (c >= '0' && c <= '9')  return c - '0';
+		if (c >= 'a' && c <= 'f')  return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F')  return c - 'A' + 10;
+		return -1;
+	}
+}
+
+juce::String SairyneBridgeCodec::percentDecode (const char* utf8, size_t numBytes, bool plusIsSpace)
+{
+	if (numBytes == 0)
+		return {};
+
+	// Decoding never grows the text
+	juce::HeapBlock<char> decoded (numBytes);
+	size_t length = 0;
+
+	for (size_t i = 0; i < numBytes; ++i)
+	{
+		const char c = utf8[i];
+
+		if (c == '%' && i + 2 < numBytes)
+		{
+			const int high = hexValue (utf8[i + 1]);
+			const int low = hexValue (utf8[i + 2]);
+
+			if (high >= 0 && low >= 0)
+			{
+				decoded[length++] = (char) ((high << 4) | low);
+				i += 2;
+				continue;
+			}
+		}
+
+		decoded[length++] = (plusIsSpace && c == '+') ? ' ' : c;
+	}
+
+	return juce::String::fromUTF8 (decoded, (int) length);
+}
+
+juce::String SairyneBridgeCodec::getQueryParameter (const juce::String& url, const char* name)
+{
+	const char* text = url.toRawUTF8();
+	const char* end = text + url.getNumBytesAsUTF8();
+	const size_t nameLength = std::strlen (name);
+
+	const char* param = static_cast<const char*> (std::memchr (text, '?', (size_t) (end - text)));
+
+	while (param != nullptr)
+	{
+		++param;
+		const char* next = static_cast<const char*> (std::memchr (param, '&', (size_t) (end - param)));
+		const char* paramEnd = next != nullptr ? next : end;
+
+		if ((size_t) (paramEnd - param) > nameLength && std::memcmp (param, name, nameLength) == 0 && param[nameLength] == '=')
+		{
+			const char* value = param + nameLength + 1;
+			return percentDecode (value, (size_t) (paramEnd - value));
+		}
+
+		param = next;
+	}
+
+	return {};
+}
+
+void SairyneBridgeCodec::writeJsonString (juce::MemoryOutputStream& out, const juce::String& text)
+{
+	static constexpr char hexDigits[] = "0123456789abcdef";
+
+	const auto* bytes = reinterpret_cast<const unsigned char*> (text.toRawUTF8());
+	const size_t numBytes = text.getNumBytesAsUTF8();
+
+	// Escapes are rare: reserve for the plain case and copy unescaped runs in one write
+	out.preallocate (out.getDataSize() + numBytes + 2);
+	out.writeByte ('"');
+
+	size_t runStart = 0;
+
+	auto flushRun = [&] (size_t runEnd)
+	{
+		if (runEnd > runStart)
+			out.write (bytes + runStart, runEnd - runStart);
+	};
+
+	for (size_t i = 0; i < numBytes; ++i)
+	{
+		const unsigned char c = bytes[i];
+		const char* escape = nullptr;
+		size_t skip = 1;
+
+		switch (c)
+		{
+			case '"':   escape = "\\\""; break;
+			case '\\':  escape = "\\\\"; break;
+			case '\n':  escape = "\\n"; break;
+			case '\r':  escape = "\\r"; break;
+			case '\t':  escape = "\\t"; break;
+			case '\b':  escape = "\\b"; break;
+			case '\f':  escape = "\\f"; break;
+			default:    break;
+		}
+
+		if (escape == nullptr && c == 0xe2 && i + 2 < numBytes && bytes[i + 1] == 0x80 && (bytes[i + 2] == 0xa8 || bytes[i + 2] == 0xa9))
+		{
+			// Line/paragraph separators are valid JSON but end a JS string literal in older engines
+			escape = bytes[i + 2] == 0xa8 ? "\\u2028" : "\\u2029";
+			skip = 3;
+		}
+
+		if (escape == nullptr && c >= 0x20)
+			continue;
+
+		flushRun (i);
+
+		if (escape != nullptr)
+		{
+			out.write (escape, std::strlen (escape));
+		}
+		else
+		{
+			const char control[] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 15] };
+			out.write (control, sizeof (control));
+		}
+
+		i += skip - 1;
+		runStart = i + 1;
+	}
+
+	flushRun (numBytes);
+	out.writeByte ('"');
+}
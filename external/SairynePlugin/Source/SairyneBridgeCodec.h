@@ -0,0 +1,18 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Text codecs for the page <-> native bridge. Stored values run to megabytes (chat state),
+// so each codec is one pass over the UTF-8 bytes into a buffer sized up front, instead of
+// a chain of String::replace calls that each copy the whole value.
+struct SairyneBridgeCodec
+{
+    // encodeURIComponent / form encoding -> text. Malformed escapes are kept as they are.
+    static juce::String percentDecode (const char* utf8, size_t numBytes, bool plusIsSpace = true);
+
+    // Decoded value of `name` in the URL's query ("juce://save?key=...&value="), empty if absent
+    static juce::String getQueryParameter (const juce::String& url, const char* name);
+
+    // Appends `text` as a quoted JSON string. Also escapes U+2028/U+2029 so the result can
+    // be pasted into a script.
+    static void writeJsonString (juce::MemoryOutputStream& out, const juce::String& text);
+};
@@ -0,0 +1,156 @@
+#include "SairyneDiagnostics.h"
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	constexpr double fixedPointScale = 16.0;
+}
+
+//==============================================================================
+int SairyneHistogram::getBucket (double value) noexcept
+{
+	if (! (value >= 1.0))
+		return 0;
+
+	const int bucket = (int) (std::log2 (value) * bucketsPerOctave) + 1;
+	return juce::jmin (bucket, numBuckets - 1);
+}
+
+double SairyneHistogram::getBucketUpperBound (int bucket) noexcept
+{
+	// The last bucket is open-ended
+	return bucket < numBuckets - 1 ? std::exp2 ((double) bucket / bucketsPerOctave)
+	                               : std::numeric_limits<double>::max();
+}
+
+void SairyneHistogram::record (double value) noexcept
+{
+	value = juce::jmax (0.0, value);
+	const auto fixed = (int64_t) (value * fixedPointScale);
+
+	buckets[(size_t) getBucket (value)].fetch_add (1, std::memory_order_relaxed);
+	count.fetch_add (1, std::memory_order_relaxed);
+	sum.fetch_add (fixed, std::memory_order_relaxed);
+
+	auto previous = maxValue.load (std::memory_order_relaxed);
+	while (fixed > previous && ! maxValue.compare_exchange_weak (previous, fixed, std::memory_order_relaxed))
+	{
+	}
+}
+
+void SairyneHistogram::reset() noexcept
+{
+	for (auto& bucket : buckets)
+		bucket.store (0, std::memory_order_relaxed);
+
+	count.store (0, std::memory_order_relaxed);
+	sum.store (0, std::memory_order_relaxed);
+	maxValue.store (0, std::memory_order_relaxed);
+}
+
+SairyneHistogram::Summary SairyneHistogram::getSummary() const noexcept
+{
+	std::array<uint32_t, numBuckets> counts;
+	int64_t total = 0;
+
+	for (size_t i = 0; i < counts.size(); ++i)
+	{
+		counts[i] = buckets[i].load (std::memory_order_relaxed);
+		total += counts[i];
+	}
+
+	Summary summary;
+	if (total == 0)
+		return summary;
+
+	summary.count = total;
+	summary.max = (double) maxValue.load (std::memory_order_relaxed) / fixedPointScale;
+	summary.mean = (double) sum.load (std::memory_order_relaxed) / fixedPointScale / (double) juce::jmax<int64_t> (1, count.load (std::memory_order_relaxed));
+
+	// Upper edge of the bucket holding the given rank, clamped to the largest value seen
+	auto percentile = [&] (double fraction)
+	{
+		const auto rank = (int64_t) std::ceil (fraction * (double) total);
+		int64_t seen = 0;
+
+		for (int bucket = 0; bucket < numBuckets; ++bucket)
+		{
+			seen += counts[(size_t) bucket];
+			if (seen >= rank)
+				return juce::jmin (getBucketUpperBound (bucket), summary.max);
+		}
+
+		return summary.max;
+	};
+
+	summary.p50 = percentile (0.50);
+	summary.p95 = percentile (0.95);
+	summary.p99 = percentile (0.99);
+	return summary;
+}
+
+juce::var SairyneHistogram::toVar() const
+{
+	const auto summary = getSummary();
+
+	auto* obj = new juce::DynamicObject();
+	obj->setProperty("count", (juce::int64) summary.count);
+	obj->setProperty("mean", summary.mean);
+	obj->setProperty("p50", summary.p50);
+	obj->setProperty("p95", summary.p95);
+	obj->setProperty("p99", summary.p99);
+	obj->setProperty("max", summary.max);
+	return juce::var (obj);
+}
+
+//==============================================================================
+double SairyneDiagnostics::ticksToMicros (juce::int64 ticks) noexcept
+{
+	return juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6;
+}
+
+double SairyneDiagnostics::getMicrosSince (juce::int64 startTicks) noexcept
+{
+	return ticksToMicros (juce::Time::getHighResolutionTicks() - startTicks);
+}
+
+void SairyneDiagnostics::recordProcessBlock (juce::int64 startTicks, int numSamples, double sampleRate) noexcept
+{
+	const double micros = getMicrosSince (startTicks);
+	processBlockMicros.record (micros);
+
+	if (numSamples <= 0 || sampleRate <= 0.0)
+		return;
+
+	const double budgetMicros = 1.0e6 * numSamples / sampleRate;
+	processBlockLoad.record (1000.0 * micros / budgetMicros);
+
+	if (micros > budgetMicros)
+		blocksOverBudget.fetch_add (1, std::memory_order_relaxed);
+}
+
+void SairyneDiagnostics::reset() noexcept
+{
+	for (auto* histogram : { &processBlockMicros, &processBlockLoad, &analysisPassMicros, &bridgeRpcHandlerMicros,
+	                         &bridgeRpcRoundTripMicros, &analysisFrameRoundTripMicros, &editorOpenColdMicros,
+	                         &editorOpenWarmMicros })
+		histogram->reset();
+
+	blocksOverBudget.store (0, std::memory_order_relaxed);
+}
+
+juce::var SairyneDiagnostics::toVar() const
+{
+	auto* obj = new juce::DynamicObject();
+	obj->setProperty("processBlockMicros", processBlockMicros.toVar());
+	obj->setProperty("processBlockLoadPerMille", processBlockLoad.toVar());
+	obj->setProperty("blocksOverBudget", (juce::int64) blocksOverBudget.load (std::memory_order_relaxed));
+	obj->setProperty("analysisPassMicros", analysisPassMicros.toVar());
+	obj->setProperty("bridgeRpcHandlerMicros", bridgeRpcHandlerMicros.toVar());
+	obj->setProperty("bridgeRpcRoundTripMicros", bridgeRpcRoundTripMicros.toVar());
+	obj->setProperty("analysisFrameRoundTripMicros", analysisFrameRoundTripMicros.toVar());
+	obj->setProperty("editorOpenColdMicros", editorOpenColdMicros.toVar());
+	obj->setProperty("editorOpenWarmMicros", editorOpenWarmMicros.toVar());
+	return juce::var (obj);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+// Lock-free histogram of non-negative values (microseconds, unless noted). Recording is a
+// handful of relaxed atomic adds, so the audio thread may record; readers get a summary
+// that can be a few samples out of step with itself, which is fine for monitoring.
+// Buckets are log-spaced, four per octave up to 2^28 (~19% wide, so percentiles are
+// within ~10%); larger values land in the last bucket.
+class SairyneHistogram
+{
+public:
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int numOctaves = 28;
+    static constexpr int numBuckets = bucketsPerOctave * numOctaves + 2;
+
+    SairyneHistogram() = default;
+
+    void record (double value) noexcept;
+    void reset() noexcept;
+
+    struct Summary
+    {
+        int64_t count = 0;
+        double mean = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    Summary getSummary() const noexcept;
+
+    // { count, mean, p50, p95, p99, max }
+    juce::var toVar() const;
+
+private:
+    static int getBucket (double value) noexcept;
+    static double getBucketUpperBound (int bucket) noexcept;
+
+    std::array<std::atomic<uint32_t>, numBuckets> buckets {};
+    std::atomic<int64_t> count { 0 };
+    std::atomic<int64_t> sum { 0 };        // in 1/16 units
+    std::atomic<int64_t> maxValue { 0 };   // in 1/16 units
+
+    JUCE_DECLARE_NON_COPYABLE (SairyneHistogram)
+};
+
+// Process-wide performance counters (one per SairyneServices), fed from the audio, analysis
+// and message threads and read by DiagnosticsStreamer ("diagnostics" event) and the CLI's
+// --bench mode. Store latencies live in SairyneStore::Stats.
+class SairyneDiagnostics
+{
+public:
+    SairyneDiagnostics() = default;
+
+    // Audio thread: one processBlock, from its start ticks
+    void recordProcessBlock (juce::int64 startTicks, int numSamples, double sampleRate) noexcept;
+
+    static double ticksToMicros (juce::int64 ticks) noexcept;
+    static double getMicrosSince (juce::int64 startTicks) noexcept;
+
+    SairyneHistogram processBlockMicros;
+    SairyneHistogram processBlockLoad;          // per mille of the block's real-time budget
+    std::atomic<int64_t> blocksOverBudget { 0 };
+
+    // Analysis scheduler: one engine's slice of a pass (up to maxHopsPerPass hops)
+    SairyneHistogram analysisPassMicros;
+
+    // Message thread: rpc request in -> reply handed to the WebView (native handler only)
+    SairyneHistogram bridgeRpcHandlerMicros;
+    // Page: callJuce() sent -> juce_rpc_result delivered, reported back in batches ("rpcTimings")
+    SairyneHistogram bridgeRpcRoundTripMicros;
+    // Message thread: analysisFrame sent -> page acknowledged it (includes the page's paint)
+    SairyneHistogram analysisFrameRoundTripMicros;
+
+    // createWebViewComponent() -> framed page loaded (see reportInteractive)
+    SairyneHistogram editorOpenColdMicros;
+    SairyneHistogram editorOpenWarmMicros;
+
+    void reset() noexcept;
+    juce::var toVar() const;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneDiagnostics)
+};
@@ -0,0 +1,226 @@
+#include "SairyneLog.h"
+#include <cstring>
+
+std::atomic<SairyneLogger*> SairyneLogger::instance { nullptr };
+
+namespace
+{
+	const char* levelName (SairyneLogLevel level)
+	{
+		switch (level)
+		{
+			case SairyneLogLevel::trace:   return "TRACE";
+			case SairyneLogLevel::debug:   return "DEBUG";
+			case SairyneLogLevel::info:    return "INFO ";
+			case SairyneLogLevel::warning: return "WARN ";
+			case SairyneLogLevel::error:   return "ERROR";
+		}
+		return "?????";
+	}
+
+	// Threads between loading SairyneLogger::instance and their last use of it; the
+	// destructor clears the pointer, then waits for these before freeing the ring
+	std::atomic<int> activeWriters { 0 };
+
+	struct ScopedWriter
+	{
+		ScopedWriter() noexcept    { activeWriters.fetch_add (1); }
+		~ScopedWriter()            { activeWriters.fetch_sub (1); }
+	};
+}
+
+SairyneLogger::SairyneLogger()
+	: juce::Thread ("Sairyne Logger")
+{
+	for (size_t i = 0; i < slots.size(); ++i)
+		slots[i].sequence.store (i, std::memory_order_relaxed);
+
+	auto logsDir = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+		.getChildFile("Sairyne");
+	logsDir.createDirectory();
+	logFile = logsDir.getChildFile("Sairyne.log");
+	openLogFile();
+
+	startThread (juce::Thread::Priority::background);
+	instance.store (this, std::memory_order_release);
+	juce::Logger::setCurrentLogger (this);
+
+	write (SairyneLogLevel::info, "==== Sairyne session started (" + juce::SystemStats::getOperatingSystemName() + ") ====");
+}
+
+SairyneLogger::~SairyneLogger()
+{
+	if (juce::Logger::getCurrentLogger() == this)
+		juce::Logger::setCurrentLogger (nullptr);
+
+	// No new writer can get the pointer after this; wait for those that already have it,
+	// so nothing pushes into the ring while it is drained and destroyed
+	instance.store (nullptr);
+	while (activeWriters.load() != 0)
+		juce::Thread::yield();
+
+	stopThread (2000);
+	drain();
+}
+
+bool SairyneLogger::shouldLog (SairyneLogLevel level) noexcept
+{
+	if (SairyneRealtimeScope::isCurrentThreadRealtime())
+	{
+		// Never format, allocate or enqueue on the audio thread
+		const ScopedWriter writer;
+		if (auto* logger = instance.load())
+			logger->refusedRealtime.fetch_add (1, std::memory_order_relaxed);
+		SairyneRealtimeScope::reportBlockingCall();
+		return false;
+	}
+
+	return (int) level >= SAIRYNE_LOG_MIN_LEVEL && instance.load (std::memory_order_acquire) != nullptr;
+}
+
+void SairyneLogger::write (SairyneLogLevel level, const juce::String& message) noexcept
+{
+	if (SairyneRealtimeScope::isCurrentThreadRealtime())
+		return;
+
+	const ScopedWriter writer;
+	if (auto* logger = instance.load())
+	{
+		if (! logger->push (level, message))
+			logger->droppedFull.fetch_add (1, std::memory_order_relaxed);
+		else if (level >= SairyneLogLevel::error)
+			logger->notify(); // get errors to disk promptly
+	}
+}
+
+void SairyneLogger::logMessage (const juce::String& message)
+{
+	// Legacy juce::Logger::writeToLog() calls
+	if (shouldLog (SairyneLogLevel::info))
+		write (SairyneLogLevel::info, message);
+}
+
+bool SairyneLogger::push (SairyneLogLevel level, const juce::String& message) noexcept
+{
+	// Bounded MPSC queue (Vyukov): producers claim a slot with one CAS, no locks
+	size_t pos = enqueuePos.load (std::memory_order_relaxed);
+	Slot* slot = nullptr;
+
+	for (;;)
+	{
+		slot = &slots[pos % numSlots];
+		const auto seq = slot->sequence.load (std::memory_order_acquire);
+		const auto diff = (std::intptr_t) seq - (std::intptr_t) pos;
+
+		if (diff == 0)
+		{
+			if (enqueuePos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false; // full
+		}
+		else
+		{
+			pos = enqueuePos.load (std::memory_order_relaxed);
+		}
+	}
+
+	const char* utf8 = message.toRawUTF8();
+	int length = (int) juce::jmin (message.getNumBytesAsUTF8(), (size_t) maxMessageBytes);
+
+	// Don't cut a multi-byte UTF-8 sequence in half
+	if (length == maxMessageBytes)
+		while (length > 0 && (utf8[length] & 0xc0) == 0x80)
+			--length;
+
+	std::memcpy (slot->text, utf8, (size_t) length);
+	slot->length = length;
+	slot->level = level;
+	slot->timeMs = juce::Time::currentTimeMillis();
+	slot->sequence.store (pos + 1, std::memory_order_release);
+	return true;
+}
+
+void SairyneLogger::run()
+{
+	while (! threadShouldExit())
+	{
+		wait (100);
+		drain();
+	}
+}
+
+void SairyneLogger::drain()
+{
+	lineBuffer.reset();
+
+	if (const auto dropped = droppedFull.exchange (0, std::memory_order_relaxed); dropped > 0)
+		lineBuffer << "[logger] " << dropped << " messages dropped (queue full)\n";
+
+	if (const auto refused = refusedRealtime.exchange (0, std::memory_order_relaxed); refused > 0)
+		lineBuffer << "[logger] " << refused << " log calls refused on the audio thread\n";
+
+	for (;;)
+	{
+		auto& slot = slots[dequeuePos % numSlots];
+		const auto seq = slot.sequence.load (std::memory_order_acquire);
+
+		if ((std::intptr_t) seq - (std::intptr_t) (dequeuePos + 1) < 0)
+			break; // empty
+
+		const juce::Time time (slot.timeMs);
+		lineBuffer << time.formatted ("%Y-%m-%d %H:%M:%S.") << juce::String (time.getMilliseconds()).paddedLeft ('0', 3)
+		           << " " << levelName (slot.level) << " ";
+		lineBuffer.write (slot.text, (size_t) slot.length);
+		lineBuffer << "\n";
+
+		slot.sequence.store (dequeuePos + numSlots, std::memory_order_release);
+		++dequeuePos;
+	}
+
+	if (lineBuffer.getDataSize() == 0)
+		return;
+
+   #if JUCE_DEBUG
+	// Mirror to the IDE console in debug builds (what DBG() used to do)
+	juce::Logger::outputDebugString (lineBuffer.toString().trimEnd());
+   #endif
+
+	if (stream != nullptr)
+	{
+		stream->write (lineBuffer.getData(), lineBuffer.getDataSize());
+		stream->flush();
+		rotateIfNeeded();
+	}
+}
+
+void SairyneLogger::openLogFile()
+{
+	stream = std::make_unique<juce::FileOutputStream> (logFile);
+
+	if (! stream->openedOk())
+		stream.reset();
+}
+
+void SairyneLogger::rotateIfNeeded()
+{
+	if (stream == nullptr || stream->getPosition() < maxFileBytes)
+		return;
+
+	stream.reset();
+
+	// Sairyne.log -> Sairyne.1.log -> ... -> Sairyne.<numRotatedFiles>.log (oldest dropped)
+	auto rotated = [this] (int index)
+	{
+		return logFile.getSiblingFile (logFile.getFileNameWithoutExtension() + "." + juce::String (index) + ".log");
+	};
+
+	rotated (numRotatedFiles).deleteFile();
+	for (int i = numRotatedFiles - 1; i >= 1; --i)
+		rotated (i).moveFileTo (rotated (i + 1));
+	logFile.moveFileTo (rotated (1));
+
+	openLogFile();
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "RealtimeContext.h"
+
+// Asynchronous, levelled logger.
+//
+// Call sites copy the message text into a fixed-size lock-free MPSC ring and return;
+// a background thread formats the lines and does all file I/O, rotating Sairyne.log by
+// size instead of deleting it on start-up. Levels below SAIRYNE_LOG_MIN_LEVEL are
+// compiled out (the message expression is never evaluated). Logging from the audio
+// thread is refused outright, in every build.
+//
+// One instance per process (juce::SharedResourcePointer); it also becomes the current
+// juce::Logger so stray juce::Logger::writeToLog calls take the same path.
+enum class SairyneLogLevel : int
+{
+    trace = 0,
+    debug = 1,
+    info = 2,
+    warning = 3,
+    error = 4
+};
+
+#ifndef SAIRYNE_LOG_MIN_LEVEL
+ #if JUCE_DEBUG
+  #define SAIRYNE_LOG_MIN_LEVEL 1 // debug
+ #else
+  #define SAIRYNE_LOG_MIN_LEVEL 2 // info
+ #endif
+#endif
+
+class SairyneLogger : public juce::Logger,
+                      private juce::Thread
+{
+public:
+    SairyneLogger();
+    ~SairyneLogger() override;
+
+    // False on the audio thread or when no logger is alive; checked before the message is built
+    static bool shouldLog (SairyneLogLevel level) noexcept;
+    static void write (SairyneLogLevel level, const juce::String& message) noexcept;
+
+    juce::File getLogFile() const { return logFile; }
+
+    static constexpr int64_t maxFileBytes = 2 * 1024 * 1024;
+    static constexpr int numRotatedFiles = 3;
+
+private:
+    static constexpr int numSlots = 1024;
+    static constexpr int maxMessageBytes = 480;
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence { 0 };
+        SairyneLogLevel level = SairyneLogLevel::info;
+        juce::int64 timeMs = 0;
+        int length = 0;
+        char text[maxMessageBytes];
+    };
+
+    void logMessage (const juce::String& message) override;
+    void run() override;
+    bool push (SairyneLogLevel level, const juce::String& message) noexcept;
+    void drain();
+    void openLogFile();
+    void rotateIfNeeded();
+
+    static std::atomic<SairyneLogger*> instance;
+
+    std::array<Slot, numSlots> slots;
+    std::atomic<size_t> enqueuePos { 0 };
+    size_t dequeuePos = 0;
+    std::atomic<int> droppedFull { 0 };
+    std::atomic<int> refusedRealtime { 0 };
+
+    juce::File logFile;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::MemoryOutputStream lineBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneLogger)
+};
+
+#define SAIRYNE_LOG(level, message) \
+    do { \
+        if constexpr ((int) (level) >= SAIRYNE_LOG_MIN_LEVEL) \
+            if (SairyneLogger::shouldLog (level)) \
+                SairyneLogger::write ((level), (message)); \
+    } while (false)
+
+#define SAIRYNE_LOG_DEBUG(message)  SAIRYNE_LOG (SairyneLogLevel::debug, message)
+#define SAIRYNE_LOG_INFO(message)   SAIRYNE_LOG (SairyneLogLevel::info, message)
+#define SAIRYNE_LOG_WARN(message)   SAIRYNE_LOG (SairyneLogLevel::warning, message)
+#define SAIRYNE_LOG_ERROR(message)  SAIRYNE_LOG (SairyneLogLevel::error, message)
@@ -0,0 +1,139 @@
+#include "SairyneServices.h"
+#include "AnalysisEngine.h"
+
+namespace
+{
+	juce::PropertiesFile::Options getLegacyPropertiesOptions()
+	{
+		juce::PropertiesFile::Options options;
+		options.applicationName = "Sairyne";
+		options.filenameSuffix = "settings";
+		options.osxLibrarySubFolder = "Application Support";
+		options.commonToAllUsers = false;
+		options.ignoreCaseOfKeyNames = false;
+		options.doNotSave = false;
+		options.millisecondsBeforeSaving = 2000;
+		options.storageFormat = juce::PropertiesFile::StorageFormat::storeAsXML;
+		return options;
+	}
+}
+
+//==============================================================================
+SairyneAnalysisScheduler::SairyneAnalysisScheduler (SairyneDiagnostics& d)
+	: juce::Thread ("Sairyne Analysis"), diagnostics (d)
+{
+}
+
+SairyneAnalysisScheduler::~SairyneAnalysisScheduler()
+{
+	// Every engine unregisters in release(), which its processor calls before it goes away
+	jassert (engines.isEmpty());
+	signalThreadShouldExit();
+	notify();
+	stopThread (2000);
+}
+
+void SairyneAnalysisScheduler::add (SairyneAnalysisEngine& engine)
+{
+	SAIRYNE_ASSERT_NOT_REALTIME();
+
+	{
+		const juce::ScopedLock sl (lock);
+		engines.addIfNotAlreadyThere (&engine);
+	}
+
+	if (! isThreadRunning())
+		startThread (juce::Thread::Priority::low);
+
+	notify();
+}
+
+void SairyneAnalysisScheduler::remove (SairyneAnalysisEngine& engine)
+{
+	SAIRYNE_ASSERT_NOT_REALTIME();
+
+	// The lock is held for a whole pass, so once we have it the engine is idle
+	const juce::ScopedLock sl (lock);
+	engines.removeFirstMatchingValue (&engine);
+}
+
+int SairyneAnalysisScheduler::getNumEngines() const
+{
+	const juce::ScopedLock sl (lock);
+	return engines.size();
+}
+
+void SairyneAnalysisScheduler::run()
+{
+	while (! threadShouldExit())
+	{
+		bool didWork = false;
+		bool idle = false;
+
+		{
+			const juce::ScopedLock sl (lock);
+			idle = engines.isEmpty();
+
+			for (auto* engine : engines)
+			{
+				const auto startTicks = juce::Time::getHighResolutionTicks();
+
+				if (engine->processPendingAudio())
+				{
+					diagnostics.analysisPassMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+					didWork = true;
+				}
+			}
+		}
+
+		// Poll rather than have audio threads signal us: WaitableEvent::signal() takes a
+		// mutex on some platforms. One hop at 96 kHz is ~10 ms, so 2 ms polling keeps up.
+		if (idle)
+			wait (-1);
+		else if (! didWork)
+			wait (2);
+	}
+}
+
+//==============================================================================
+SairyneServices::SairyneServices()
+{
+	SAIRYNE_LOG_DEBUG("SairyneServices: created");
+}
+
+SairyneServices::~SairyneServices()
+{
+	store.reset();
+	legacyProperties.reset();
+	SAIRYNE_LOG_DEBUG("SairyneServices: destroyed");
+}
+
+juce::PropertiesFile& SairyneServices::getLegacyProperties()
+{
+	const juce::ScopedLock sl (storeLock);
+
+	if (legacyProperties == nullptr)
+	{
+		legacyProperties = std::make_unique<juce::PropertiesFile>(getLegacyPropertiesOptions());
+		SAIRYNE_LOG_DEBUG("PropertiesFile created: " + legacyProperties->getFile().getFullPathName());
+	}
+
+	return *legacyProperties;
+}
+
+SairyneStore& SairyneServices::getStore()
+{
+	const juce::ScopedLock sl (storeLock);
+
+	if (store == nullptr)
+	{
+		// Lives next to the legacy Sairyne.settings; the XML file is only parsed once, to migrate
+		const auto legacyFile = getLegacyPropertiesOptions().getDefaultFile();
+		store = std::make_unique<SairyneStore>(legacyFile.getSiblingFile("SairyneStore"));
+
+		if (store->isEmpty() && legacyFile.existsAsFile())
+			store->importFrom(getLegacyProperties());
+	}
+
+	return *store;
+}
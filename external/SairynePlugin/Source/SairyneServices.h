@@ -0,0 +1,77 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include "SairyneDiagnostics.h"
+#include "SairyneLog.h"
+#include "SairyneStore.h"
+#include "SairyneTrackBus.h"
+
+class SairyneAnalysisEngine;
+
+// Drives every instance's SairyneAnalysisEngine from one background thread instead of
+// one thread per plugin instance. Engines register in prepare() and unregister in
+// release(); each pass gives every engine a bounded slice of its queued audio.
+class SairyneAnalysisScheduler : private juce::Thread
+{
+public:
+    explicit SairyneAnalysisScheduler (SairyneDiagnostics& diagnostics);
+    ~SairyneAnalysisScheduler() override;
+
+    void add (SairyneAnalysisEngine& engine);
+    // Returns once the engine is no longer being processed
+    void remove (SairyneAnalysisEngine& engine);
+
+    int getNumEngines() const;
+
+private:
+    void run() override;
+
+    SairyneDiagnostics& diagnostics;
+    juce::CriticalSection lock;
+    juce::Array<SairyneAnalysisEngine*> engines;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneAnalysisScheduler)
+};
+
+// Process-wide services shared by all plugin instances (juce::SharedResourcePointer):
+// one logger, one journaled store, one analysis thread, the cross-track summary bus and
+// the performance counters.
+// Created with the first instance and destroyed with the last.
+class SairyneServices
+{
+public:
+    SairyneServices();
+    ~SairyneServices();
+
+    SairyneLogger& getLogger() { return *logger; }
+
+    // Created on first use; imports the legacy Sairyne.settings once
+    SairyneStore& getStore();
+
+    // Legacy XML settings (only read to migrate into the store)
+    juce::PropertiesFile& getLegacyProperties();
+
+    SairyneAnalysisScheduler& getAnalysisScheduler() { return scheduler; }
+    SairyneTrackBus& getTrackBus() { return trackBus; }
+    SairyneDiagnostics& getDiagnostics() { return diagnostics; }
+
+    int getNumInstances() const noexcept { return numInstances.load(); }
+    int instanceCreated() noexcept { return ++numInstances; }
+    void instanceDestroyed() noexcept { --numInstances; }
+
+private:
+    // Declared first so it outlives everything that logs
+    juce::SharedResourcePointer<SairyneLogger> logger;
+
+    juce::CriticalSection storeLock;
+    std::unique_ptr<juce::PropertiesFile> legacyProperties;
+    std::unique_ptr<SairyneStore> store;
+
+    SairyneDiagnostics diagnostics;
+    SairyneTrackBus trackBus;
+    SairyneAnalysisScheduler scheduler { diagnostics };
+    std::atomic<int> numInstances { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneServices)
+};
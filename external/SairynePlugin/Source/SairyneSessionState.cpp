@@ -0,0 +1,272 @@
+#include "SairyneSessionState.h"
+#include "SairyneLog.h"
+
+namespace
+{
+	constexpr int chunkMagic     = 0x4e595253; // "SRYN"
+	constexpr int formatVersion  = 1;
+	constexpr int headerBytes    = 4 + 2 + 2;
+	constexpr int maxNameBytes   = 1024;
+	constexpr int maxSections    = 0xffff;
+
+	// Bounds-checked little-endian reader over the host's chunk
+	struct ChunkReader
+	{
+		const char* data;
+		size_t size, pos = 0;
+
+		bool canRead (size_t numBytes) const noexcept  { return numBytes <= size - pos; }
+		uint8_t  readByte() noexcept                   { return (uint8_t) data[pos++]; }
+		uint16_t readShort() noexcept                  { auto v = juce::ByteOrder::littleEndianShort (data + pos); pos += 2; return v; }
+		uint32_t readInt() noexcept                    { auto v = juce::ByteOrder::littleEndianInt (data + pos); pos += 4; return v; }
+	};
+}
+
+juce::String SairyneSessionState::getValue (const juce::String& name) const
+{
+	const juce::ScopedLock sl (lock);
+
+	const auto it = sections.find (name);
+	if (it == sections.end() || it->second.opaque)
+		return {};
+
+	if (! it->second.decoded)
+		decode (it->second);
+
+	return it->second.value;
+}
+
+bool SairyneSessionState::setValue (const juce::String& name, const juce::String& value)
+{
+	if (value.isEmpty())
+		return removeValue (name);
+
+	if (name.isEmpty() || name.getNumBytesAsUTF8() > (size_t) maxNameBytes)
+	{
+		jassertfalse;
+		return false;
+	}
+
+	const juce::ScopedLock sl (lock);
+
+	if (const auto it = sections.find (name); it != sections.end() && ! it->second.opaque)
+	{
+		// The UI re-saves unchanged state a lot; that must not dirty the host session
+		if (! it->second.decoded)
+			decode (it->second);
+
+		if (it->second.value == value)
+			return false;
+	}
+	else if ((int) sections.size() >= maxSections)
+	{
+		jassertfalse;
+		return false;
+	}
+
+	auto& section = sections[name];
+	section.value = value;
+	section.decoded = true;
+	section.dirty = true;
+	section.opaque = false;
+	chunkValid = false;
+	return true;
+}
+
+bool SairyneSessionState::removeValue (const juce::String& name)
+{
+	const juce::ScopedLock sl (lock);
+
+	if (sections.erase (name) == 0)
+		return false;
+
+	chunkValid = false;
+	return true;
+}
+
+int SairyneSessionState::getNumSections() const
+{
+	const juce::ScopedLock sl (lock);
+	return (int) sections.size();
+}
+
+juce::StringArray SairyneSessionState::getNames() const
+{
+	const juce::ScopedLock sl (lock);
+	juce::StringArray names;
+
+	for (const auto& [name, section] : sections)
+		if (! section.opaque)
+			names.add (name);
+
+	return names;
+}
+
+void SairyneSessionState::writeTo (juce::MemoryBlock& dest)
+{
+	const juce::ScopedLock sl (lock);
+
+	if (! chunkValid)
+	{
+		for (auto& [name, section] : sections)
+			if (section.dirty)
+				encode (section);
+
+		lastChunk.reset();
+		juce::MemoryOutputStream out (lastChunk, false);
+
+		out.writeInt (chunkMagic);
+		out.writeShort ((short) formatVersion);
+		out.writeShort ((short) sections.size());
+
+		uint32_t offset = 0;
+		for (const auto& [name, section] : sections)
+		{
+			const auto nameBytes = name.getNumBytesAsUTF8();
+			out.writeShort ((short) nameBytes);
+			out.write (name.toRawUTF8(), nameBytes);
+			out.writeByte ((char) section.encoding);
+			out.writeInt ((int) section.rawBytes);
+			out.writeInt ((int) offset);
+			out.writeInt ((int) section.stored.getSize());
+			offset += (uint32_t) section.stored.getSize();
+		}
+
+		for (const auto& [name, section] : sections)
+			out.write (section.stored.getData(), section.stored.getSize());
+
+		out.flush();
+		chunkValid = true;
+	}
+
+	dest = lastChunk;
+}
+
+bool SairyneSessionState::restoreFrom (const void* data, int sizeInBytes)
+{
+	std::map<juce::String, Section> restored;
+
+	auto parse = [&]
+	{
+		if (data == nullptr || sizeInBytes < headerBytes)
+			return false;
+
+		ChunkReader reader { static_cast<const char*> (data), (size_t) sizeInBytes };
+
+		if ((int) reader.readInt() != chunkMagic)
+			return false;
+
+		if (const int version = reader.readShort(); version != formatVersion)
+		{
+			SAIRYNE_LOG_WARN("Session state: unsupported version " + juce::String(version));
+			return false;
+		}
+
+		struct Entry { juce::String name; Encoding encoding; uint32_t rawBytes, offset, storedBytes; };
+		std::vector<Entry> entries ((size_t) reader.readShort());
+
+		for (auto& entry : entries)
+		{
+			if (! reader.canRead (2))
+				return false;
+
+			const auto nameBytes = reader.readShort();
+			if (! reader.canRead ((size_t) nameBytes + 1 + 4 + 4 + 4))
+				return false;
+
+			entry.name = juce::String::fromUTF8 (reader.data + reader.pos, nameBytes);
+			reader.pos += nameBytes;
+			entry.encoding = (Encoding) reader.readByte();
+			entry.rawBytes = reader.readInt();
+			entry.offset = reader.readInt();
+			entry.storedBytes = reader.readInt();
+		}
+
+		const size_t payloadStart = reader.pos;
+		const size_t payloadSize = reader.size - payloadStart;
+
+		for (const auto& entry : entries)
+		{
+			if ((size_t) entry.offset > payloadSize || (size_t) entry.storedBytes > payloadSize - entry.offset)
+				return false;
+
+			// Kept compressed until someone reads it
+			auto& section = restored[entry.name];
+			section.stored.replaceAll (reader.data + payloadStart + entry.offset, entry.storedBytes);
+			section.encoding = entry.encoding;
+			section.rawBytes = entry.rawBytes;
+			section.opaque = entry.encoding != Encoding::raw && entry.encoding != Encoding::zlib;
+		}
+
+		return true;
+	};
+
+	const bool ok = parse();
+	const juce::ScopedLock sl (lock);
+
+	if (! ok)
+	{
+		SAIRYNE_LOG_WARN("Session state: ignoring invalid chunk (" + juce::String(sizeInBytes) + " bytes)");
+		sections.clear();
+		chunkValid = false;
+		return false;
+	}
+
+	sections = std::move (restored);
+
+	// Every section is kept, opaque ones included: the host's bytes are the current chunk
+	lastChunk.replaceAll (data, (size_t) sizeInBytes);
+	chunkValid = true;
+
+	return true;
+}
+
+void SairyneSessionState::encode (Section& section)
+{
+	const auto* utf8 = section.value.toRawUTF8();
+	const auto numBytes = section.value.getNumBytesAsUTF8();
+
+	section.rawBytes = (uint32_t) numBytes;
+	section.encoding = Encoding::raw;
+	section.dirty = false;
+
+	if (numBytes >= minBytesToCompress)
+	{
+		juce::MemoryOutputStream compressed;
+		{
+			juce::GZIPCompressorOutputStream zlib (compressed);
+			zlib.write (utf8, numBytes);
+		}
+
+		if (compressed.getDataSize() < numBytes)
+		{
+			section.stored = compressed.getMemoryBlock();
+			section.encoding = Encoding::zlib;
+			return;
+		}
+	}
+
+	section.stored.replaceAll (utf8, numBytes);
+}
+
+void SairyneSessionState::decode (Section& section)
+{
+	section.decoded = true;
+
+	if (section.encoding == Encoding::raw)
+	{
+		section.value = juce::String::fromUTF8 (static_cast<const char*> (section.stored.getData()), (int) section.stored.getSize());
+		return;
+	}
+
+	juce::MemoryInputStream source (section.stored, false);
+	juce::GZIPDecompressorInputStream zlib (source);
+	juce::MemoryBlock raw;
+	zlib.readIntoMemoryBlock (raw);
+
+	if (raw.getSize() != section.rawBytes)
+		SAIRYNE_LOG_WARN("Session state: section decoded to " + juce::String((int) raw.getSize())
+			+ " bytes, expected " + juce::String((int) section.rawBytes));
+
+	section.value = juce::String::fromUTF8 (static_cast<const char*> (raw.getData()), (int) raw.getSize());
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+
+// Project-scoped state (chat state, selected project, track role, ...) stored in the host
+// session through get/setStateInformation, as named string sections.
+//
+// Hosts save often (Ableton autosaves every few seconds, for every instance), so:
+//   - a section is compressed only when it changes; unchanged sections reuse their bytes,
+//     and with nothing dirty the previous chunk is handed back as-is;
+//   - restoring only parses the section table; a section is decompressed on first read.
+//
+// Chunk (all integers little-endian):
+//   header  : { 'SRYN', version u16, numSections u16 }
+//   table   : per section, sorted by name: { nameBytes u16, name, encoding u8,
+//             rawBytes u32, offset u32, storedBytes u32 }
+//   payload : section bytes; offsets are relative to the end of the table
+// encoding 0 = UTF-8 as-is, 1 = zlib. A section in an encoding this build can't read (saved
+// by a newer build) is kept as opaque bytes and written back unchanged; it reads as empty
+// until something overwrites it.
+// Thread-safe: hosts call get/setStateInformation from various threads.
+class SairyneSessionState
+{
+public:
+    SairyneSessionState() = default;
+
+    juce::String getValue (const juce::String& name) const;
+    // Returns false if the value was already stored (the chunk stays clean)
+    bool setValue (const juce::String& name, const juce::String& value);
+    bool removeValue (const juce::String& name);
+
+    void writeTo (juce::MemoryBlock& dest);
+    // Replaces every section; false (and the state left empty) if the data is not a valid chunk
+    bool restoreFrom (const void* data, int sizeInBytes);
+
+    int getNumSections() const;
+    // Names of the readable sections (opaque ones are left out)
+    juce::StringArray getNames() const;
+
+    // Sections smaller than this are stored uncompressed
+    static constexpr size_t minBytesToCompress = 128;
+
+private:
+    enum class Encoding : uint8_t { raw = 0, zlib = 1 };
+
+    struct Section
+    {
+        juce::MemoryBlock stored;       // payload as it appears in the chunk
+        Encoding encoding = Encoding::raw;
+        uint32_t rawBytes = 0;
+        juce::String value;             // valid once decoded
+        bool decoded = false;
+        bool dirty = false;             // value changed since `stored` was encoded
+        bool opaque = false;            // unknown encoding: `stored` is written back as-is
+    };
+
+    static void encode (Section&);
+    static void decode (Section&);
+
+    mutable juce::CriticalSection lock;
+    mutable std::map<juce::String, Section> sections;
+    juce::MemoryBlock lastChunk;
+    bool chunkValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneSessionState)
+};
@@ -0,0 +1,447 @@
+#include "SairyneStore.h"
+#include "SairyneLog.h"
+#include <array>
+
+namespace
+{
+	constexpr int snapshotMagic = 0x4e535253; // "SRSN"
+	constexpr int journalMagic  = 0x4e4a5253; // "SRJN"
+	constexpr int formatVersion = 1;
+	constexpr int headerBytes   = 4 + 4 + 8;
+	constexpr int maxFieldBytes = 256 * 1024 * 1024;
+
+	uint32_t crc32 (const void* data, size_t numBytes, uint32_t crc = 0)
+	{
+		static const auto table = []
+		{
+			std::array<uint32_t, 256> t {};
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t c = i;
+				for (int k = 0; k < 8; ++k)
+					c = (c & 1) != 0 ? 0xedb88320u ^ (c >> 1) : (c >> 1);
+				t[i] = c;
+			}
+			return t;
+		}();
+
+		auto* bytes = static_cast<const uint8_t*> (data);
+		crc = ~crc;
+		for (size_t i = 0; i < numBytes; ++i)
+			crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	void writeHeader (juce::OutputStream& out, int magic, uint64_t generation)
+	{
+		out.writeInt (magic);
+		out.writeInt (formatVersion);
+		out.writeInt64 ((juce::int64) generation);
+	}
+
+	bool readHeader (const juce::MemoryBlock& data, int expectedMagic, uint64_t& generation)
+	{
+		if (data.getSize() < (size_t) headerBytes)
+			return false;
+
+		auto* p = static_cast<const char*> (data.getData());
+		if (juce::ByteOrder::littleEndianInt (p) != (juce::uint32) expectedMagic
+			|| juce::ByteOrder::littleEndianInt (p + 4) != (juce::uint32) formatVersion)
+			return false;
+
+		generation = juce::ByteOrder::littleEndianInt64 (p + 8);
+		return true;
+	}
+
+	void writeRecord (juce::MemoryOutputStream& out, uint8_t op, const juce::String& key, const juce::String& value)
+	{
+		const auto keyBytes = (juce::uint32) key.getNumBytesAsUTF8();
+		const auto valueBytes = (juce::uint32) value.getNumBytesAsUTF8();
+		const auto start = out.getDataSize();
+
+		out.writeByte ((char) op);
+		out.writeInt ((int) keyBytes);
+		out.writeInt ((int) valueBytes);
+		out.write (key.toRawUTF8(), keyBytes);
+		out.write (value.toRawUTF8(), valueBytes);
+
+		const auto* recordStart = static_cast<const char*> (out.getData()) + start;
+		out.writeInt ((int) crc32 (recordStart, out.getDataSize() - start));
+	}
+
+	// Calls onRecord for each intact record after the header; returns the offset of the
+	// first byte that is not part of an intact record (== size when the file is clean).
+	template <typename Callback>
+	size_t readRecords (const juce::MemoryBlock& data, Callback&& onRecord)
+	{
+		auto* base = static_cast<const char*> (data.getData());
+		const size_t size = data.getSize();
+		size_t pos = (size_t) headerBytes;
+
+		while (pos + 9 <= size)
+		{
+			const auto op = (uint8_t) base[pos];
+			const auto keyBytes = juce::ByteOrder::littleEndianInt (base + pos + 1);
+			const auto valueBytes = juce::ByteOrder::littleEndianInt (base + pos + 5);
+
+			if (keyBytes > (juce::uint32) maxFieldBytes || valueBytes > (juce::uint32) maxFieldBytes)
+				break;
+
+			const size_t bodyBytes = 9 + (size_t) keyBytes + (size_t) valueBytes;
+			if (pos + bodyBytes + 4 > size)
+				break;
+
+			if (crc32 (base + pos, bodyBytes) != juce::ByteOrder::littleEndianInt (base + pos + bodyBytes))
+				break;
+
+			onRecord (op,
+			          juce::String::fromUTF8 (base + pos + 9, (int) keyBytes),
+			          juce::String::fromUTF8 (base + pos + 9 + keyBytes, (int) valueBytes));
+			pos += bodyBytes + 4;
+		}
+
+		return pos;
+	}
+}
+
+SairyneStore::SairyneStore (const juce::File& dir)
+	: juce::Thread ("Sairyne Store"),
+	  directory (dir),
+	  snapshotFile (dir.getChildFile ("store.snapshot")),
+	  journalFile (dir.getChildFile ("store.journal"))
+{
+	directory.createDirectory();
+	load();
+	startThread (juce::Thread::Priority::background);
+}
+
+SairyneStore::~SairyneStore()
+{
+	// run() drains whatever is still pending before it returns
+	signalThreadShouldExit();
+	notify();
+	stopThread (10000);
+}
+
+juce::String SairyneStore::getValue (const juce::String& key, const juce::String& defaultValue) const
+{
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+	juce::String value;
+	{
+		const juce::ScopedLock lock (valuesLock);
+		const auto it = values.find (key);
+		value = it != values.end() ? it->second : defaultValue;
+	}
+
+	stats.getMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+	return value;
+}
+
+bool SairyneStore::containsKey (const juce::String& key) const
+{
+	const juce::ScopedLock lock (valuesLock);
+	return values.find (key) != values.end();
+}
+
+bool SairyneStore::isEmpty() const
+{
+	const juce::ScopedLock lock (valuesLock);
+	return values.empty();
+}
+
+void SairyneStore::setValue (const juce::String& key, const juce::String& value)
+{
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+	bool changed = true;
+
+	{
+		const juce::ScopedLock lock (valuesLock);
+		const auto [it, inserted] = values.try_emplace (key);
+		auto& slot = it->second;
+
+		// The UI re-saves unchanged state a lot; don't journal no-ops
+		if (! inserted && slot == value)
+		{
+			changed = false;
+		}
+		else
+		{
+			// Same accounting as load(): key and value bytes of every live entry
+			liveBytes += (inserted ? (int64_t) key.getNumBytesAsUTF8() : 0)
+			           + (int64_t) value.getNumBytesAsUTF8() - (int64_t) slot.getNumBytesAsUTF8();
+			slot = value;
+		}
+	}
+
+	if (changed)
+	{
+		{
+			const juce::ScopedLock lock (pendingLock);
+			pending[key] = value;
+		}
+
+		notify();
+	}
+
+	stats.setMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+}
+
+void SairyneStore::removeValue (const juce::String& key)
+{
+	{
+		const juce::ScopedLock lock (valuesLock);
+		const auto it = values.find (key);
+		if (it == values.end())
+			return;
+
+		liveBytes -= (int64_t) key.getNumBytesAsUTF8() + (int64_t) it->second.getNumBytesAsUTF8();
+		values.erase (it);
+	}
+
+	{
+		const juce::ScopedLock lock (pendingLock);
+		pending[key] = std::nullopt;
+	}
+
+	notify();
+}
+
+void SairyneStore::importFrom (juce::PropertiesFile& legacy)
+{
+	const auto& all = legacy.getAllProperties();
+	const auto keys = all.getAllKeys();
+	const auto legacyValues = all.getAllValues();
+
+	for (int i = 0; i < keys.size(); ++i)
+		if (legacyValues[i].isNotEmpty())
+			setValue (keys[i], legacyValues[i]);
+
+	SAIRYNE_LOG_INFO("SairyneStore: imported " + juce::String(keys.size()) + " keys from " + legacy.getFile().getFullPathName());
+}
+
+void SairyneStore::load()
+{
+	uint64_t snapshotGeneration = 0;
+	juce::MemoryBlock data;
+
+	if (snapshotFile.existsAsFile() && snapshotFile.loadFileAsData (data) && readHeader (data, snapshotMagic, snapshotGeneration))
+	{
+		readRecords (data, [this] (uint8_t op, const juce::String& key, const juce::String& value)
+		{
+			if (op == (uint8_t) Op::set)
+				values[key] = value;
+		});
+	}
+
+	generation = snapshotGeneration;
+	bool journalIsClean = false;
+	uint64_t journalGeneration = 0;
+	data.reset();
+
+	if (journalFile.existsAsFile() && journalFile.loadFileAsData (data) && readHeader (data, journalMagic, journalGeneration))
+	{
+		// A journal from an older generation was already folded into the snapshot
+		// (crash between snapshot rename and journal reset) - ignore it.
+		if (journalGeneration == snapshotGeneration)
+		{
+			const auto validBytes = readRecords (data, [this] (uint8_t op, const juce::String& key, const juce::String& value)
+			{
+				if (op == (uint8_t) Op::set)
+					values[key] = value;
+				else if (op == (uint8_t) Op::remove)
+					values.erase (key);
+			});
+
+			journalIsClean = validBytes == data.getSize();
+			journalBytes = (int64_t) validBytes;
+
+			if (! journalIsClean)
+			{
+				SAIRYNE_LOG_WARN("SairyneStore: journal has a torn tail at byte " + juce::String((juce::int64) validBytes) + ", recovering");
+			}
+		}
+	}
+
+	for (const auto& entry : values)
+		liveBytes += (int64_t) entry.first.getNumBytesAsUTF8() + (int64_t) entry.second.getNumBytesAsUTF8();
+
+	SAIRYNE_LOG_INFO("SairyneStore: loaded " + juce::String((int) values.size()) + " keys from " + directory.getFullPathName());
+
+	// A stale or damaged journal can't be appended to; fold everything into a fresh snapshot
+	if (journalIsClean)
+	{
+		openJournal (false);
+	}
+	else
+	{
+		journalDamaged = true;
+		compact();
+	}
+}
+
+bool SairyneStore::openJournal (bool truncate)
+{
+	journal.reset();
+
+	if (truncate || ! journalFile.existsAsFile())
+	{
+		juce::TemporaryFile temp (journalFile);
+		{
+			juce::FileOutputStream out (temp.getFile());
+			if (! out.openedOk())
+				return false;
+			writeHeader (out, journalMagic, generation);
+			out.flush();
+		}
+
+		if (! temp.overwriteTargetFileWithTemporary())
+			return false;
+
+		journalBytes = headerBytes;
+	}
+
+	journal = std::make_unique<juce::FileOutputStream> (journalFile);
+	if (! journal->openedOk())
+	{
+		SAIRYNE_LOG_WARN("SairyneStore: cannot open journal " + journalFile.getFullPathName());
+		journal.reset();
+		return false;
+	}
+
+	return true;
+}
+
+void SairyneStore::run()
+{
+	while (! threadShouldExit())
+	{
+		wait (-1);
+
+		// Let a burst of edits (chat state changes on every message) collapse into one append
+		for (int waited = 0; waited < writeBehindMs && ! threadShouldExit(); waited += 10)
+			juce::Thread::sleep (10);
+
+		if (writePending())
+		{
+			int64_t live;
+			{
+				const juce::ScopedLock lock (valuesLock);
+				live = liveBytes;
+			}
+
+			if (journalBytes > juce::jmax (minJournalBytesForCompaction, live * 2))
+				compact();
+		}
+	}
+
+	writePending();
+}
+
+bool SairyneStore::writePending()
+{
+	PendingMap batch;
+	{
+		const juce::ScopedLock lock (pendingLock);
+		batch.swap (pending);
+	}
+
+	if (batch.empty())
+		return false;
+
+	// Keep the changes queued (newer edits win) and retry on the next wake-up
+	auto requeue = [this, &batch]
+	{
+		const juce::ScopedLock lock (pendingLock);
+		for (auto& entry : batch)
+			pending.insert (std::move (entry));
+	};
+
+	// A failed append may have left a torn record, and load() stops replaying there: never
+	// append after it, start a new generation instead
+	if (journalDamaged)
+		compact();
+
+	if (journalDamaged || (journal == nullptr && ! openJournal (false)))
+	{
+		requeue();
+		return false;
+	}
+
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+
+	juce::MemoryOutputStream buffer;
+	for (const auto& entry : batch)
+	{
+		if (entry.second.has_value())
+			writeRecord (buffer, (uint8_t) Op::set, entry.first, *entry.second);
+		else
+			writeRecord (buffer, (uint8_t) Op::remove, entry.first, {});
+	}
+
+	journal->write (buffer.getData(), buffer.getDataSize());
+	journal->flush(); // fsyncs on POSIX
+
+	if (journal->getStatus().failed())
+	{
+		SAIRYNE_LOG_ERROR("SairyneStore: journal write failed: " + journal->getStatus().getErrorMessage());
+		journal.reset();
+		journalDamaged = true;
+		requeue();
+		compact();
+		return false;
+	}
+
+	journalBytes += (int64_t) buffer.getDataSize();
+	stats.recordsWritten += (int64_t) batch.size();
+	stats.bytesWritten += (int64_t) buffer.getDataSize();
+	++stats.batchesWritten;
+	stats.flushMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+	return true;
+}
+
+void SairyneStore::compact()
+{
+	std::map<juce::String, juce::String> copy;
+	{
+		// juce::String is ref-counted, so this copies pointers, not payloads
+		const juce::ScopedLock lock (valuesLock);
+		copy = values;
+	}
+
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+	const auto nextGeneration = generation + 1;
+
+	juce::MemoryOutputStream buffer;
+	writeHeader (buffer, snapshotMagic, nextGeneration);
+	for (const auto& entry : copy)
+		writeRecord (buffer, (uint8_t) Op::set, entry.first, entry.second);
+
+	juce::TemporaryFile temp (snapshotFile);
+	{
+		juce::FileOutputStream out (temp.getFile());
+		if (! out.openedOk())
+			return;
+
+		out.write (buffer.getData(), buffer.getDataSize());
+		out.flush();
+
+		if (out.getStatus().failed())
+			return;
+	}
+
+	// Atomic rename: readers see either the old or the new snapshot, never a partial one
+	if (! temp.overwriteTargetFileWithTemporary())
+	{
+		SAIRYNE_LOG_WARN("SairyneStore: snapshot rename failed");
+		return;
+	}
+
+	generation = nextGeneration;
+
+	// The old journal now belongs to an older generation and load() ignores it, so if a
+	// fresh one can't be started, the next write must compact again rather than append
+	journalDamaged = ! openJournal (true);
+	++stats.compactions;
+	stats.bytesWritten += (int64_t) buffer.getDataSize();
+	stats.compactionMicros.record (SairyneDiagnostics::getMicrosSince (startTicks));
+}
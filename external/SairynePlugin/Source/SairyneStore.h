@@ -0,0 +1,86 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <map>
+#include <optional>
+#include "SairyneDiagnostics.h"
+
+// Key-value storage for the web UI (users, projects, chat state).
+//
+// Reads and writes hit an in-memory map, so the message thread never touches disk.
+// Changes are coalesced per key and appended to a journal by a background writer
+// thread (write-behind). When the journal outgrows the live data it is compacted
+// into a snapshot, written to a temporary file and atomically renamed into place.
+//
+// On disk (all integers little-endian):
+//   store.snapshot : header { 'SRSN', version, generation } + set records
+//   store.journal  : header { 'SRJN', version, generation } + set/remove records
+//   record         : { op u8, keyBytes u32, valueBytes u32, key, value, crc32 u32 }
+// Recovery loads the snapshot, then replays the journal only if its generation matches,
+// stopping at the first torn or corrupt record (a crash mid-append loses only that record).
+// For the same reason nothing is appended after a failed write: the batch is re-queued and
+// the store compacts into a new generation with a fresh journal.
+class SairyneStore : private juce::Thread
+{
+public:
+    explicit SairyneStore (const juce::File& directory);
+    ~SairyneStore() override;
+
+    juce::String getValue (const juce::String& key, const juce::String& defaultValue = {}) const;
+    bool containsKey (const juce::String& key) const;
+    void setValue (const juce::String& key, const juce::String& value);
+    void removeValue (const juce::String& key);
+    bool isEmpty() const;
+
+    // One-time migration from the legacy XML PropertiesFile (the legacy file is left untouched)
+    void importFrom (juce::PropertiesFile& legacy);
+
+    juce::File getDirectory() const { return directory; }
+
+    struct Stats
+    {
+        std::atomic<int64_t> recordsWritten { 0 };
+        std::atomic<int64_t> bytesWritten { 0 };
+        std::atomic<int64_t> batchesWritten { 0 };
+        std::atomic<int64_t> compactions { 0 };
+
+        // Caller's thread: getValue / setValue, locks included
+        SairyneHistogram getMicros, setMicros;
+        // Writer thread: one batch appended and flushed (fsync), or one compaction
+        SairyneHistogram flushMicros, compactionMicros;
+    };
+
+    const Stats& getStats() const noexcept { return stats; }
+
+private:
+    enum class Op : uint8_t { set = 1, remove = 2 };
+    using PendingMap = std::map<juce::String, std::optional<juce::String>>;
+
+    static constexpr int writeBehindMs = 250;
+    static constexpr int64_t minJournalBytesForCompaction = 1 << 20;
+
+    void run() override;
+    void load();
+    bool writePending();
+    void compact();
+    bool openJournal (bool truncate);
+
+    const juce::File directory, snapshotFile, journalFile;
+
+    mutable juce::CriticalSection valuesLock;
+    std::map<juce::String, juce::String> values;
+    int64_t liveBytes = 0;
+
+    juce::CriticalSection pendingLock;
+    PendingMap pending;
+
+    // Writer thread only
+    std::unique_ptr<juce::FileOutputStream> journal;
+    uint64_t generation = 0;
+    int64_t journalBytes = 0;
+    bool journalDamaged = false;    // may end in a torn record: compact before writing again
+
+    mutable Stats stats;    // mutable: getValue() records its latency
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneStore)
+};
@@ -0,0 +1,205 @@
+#include "SairyneTrackBus.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr int maxReadAttempts = 8;
+}
+
+SairyneTrackBus::SairyneTrackBus()
+{
+	for (auto& slot : slots)
+	{
+		for (auto& level : slot.bandDb)
+			level.store (SpectralBands::silenceDb, std::memory_order_relaxed);
+
+		for (auto& c : slot.name)
+			c.store (0, std::memory_order_relaxed);
+	}
+}
+
+int SairyneTrackBus::claimSlot()
+{
+	for (int i = 0; i < maxTracks; ++i)
+	{
+		auto& slot = slots[(size_t) i];
+		bool expected = false;
+
+		if (slot.inUse.compare_exchange_strong (expected, true, std::memory_order_acq_rel))
+		{
+			slot.isMaster.store (false, std::memory_order_relaxed);
+			slot.lastPublishMs.store (0, std::memory_order_relaxed);
+			setTrackName (i, {});
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void SairyneTrackBus::releaseSlot (int index)
+{
+	if (! juce::isPositiveAndBelow (index, maxTracks))
+		return;
+
+	auto& slot = slots[(size_t) index];
+	slot.lastPublishMs.store (0, std::memory_order_relaxed);
+	slot.isMaster.store (false, std::memory_order_relaxed);
+	slot.inUse.store (false, std::memory_order_release);
+}
+
+void SairyneTrackBus::setTrackName (int index, const juce::String& name)
+{
+	if (! juce::isPositiveAndBelow (index, maxTracks))
+		return;
+
+	auto& slot = slots[(size_t) index];
+	const char* utf8 = name.toRawUTF8();
+	int length = (int) juce::jmin (name.getNumBytesAsUTF8(), (size_t) maxNameBytes);
+
+	// Don't cut a multi-byte UTF-8 sequence in half
+	if (length == maxNameBytes)
+		while (length > 0 && (utf8[length] & 0xc0) == 0x80)
+			--length;
+
+	const juce::ScopedLock lock (nameWriteLock);
+	const auto sequence = slot.nameSequence.load (std::memory_order_relaxed);
+	slot.nameSequence.store (sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence (std::memory_order_release);
+
+	for (int i = 0; i < maxNameBytes; ++i)
+		slot.name[(size_t) i].store (i < length ? utf8[i] : 0, std::memory_order_relaxed);
+
+	slot.nameSequence.store (sequence + 2, std::memory_order_release);
+}
+
+void SairyneTrackBus::setMaster (int index, bool isMaster)
+{
+	if (juce::isPositiveAndBelow (index, maxTracks))
+		slots[(size_t) index].isMaster.store (isMaster, std::memory_order_relaxed);
+}
+
+void SairyneTrackBus::publish (int index, const Summary& summary) noexcept
+{
+	if (! juce::isPositiveAndBelow (index, maxTracks))
+		return;
+
+	auto& slot = slots[(size_t) index];
+	const auto sequence = slot.summarySequence.load (std::memory_order_relaxed);
+
+	// Odd sequence = write in progress
+	slot.summarySequence.store (sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence (std::memory_order_release);
+
+	for (size_t band = 0; band < summary.bandDb.size(); ++band)
+		slot.bandDb[band].store (summary.bandDb[band], std::memory_order_relaxed);
+	slot.shortTermLufs.store (summary.shortTermLufs, std::memory_order_relaxed);
+
+	slot.summarySequence.store (sequence + 2, std::memory_order_release);
+	slot.lastPublishMs.store (juce::jmax ((juce::uint32) 1, juce::Time::getMillisecondCounter()), std::memory_order_relaxed);
+}
+
+bool SairyneTrackBus::readSummary (const Slot& slot, Summary& dest) const noexcept
+{
+	for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+	{
+		const auto before = slot.summarySequence.load (std::memory_order_acquire);
+		if ((before & 1) != 0)
+			continue;
+
+		for (size_t band = 0; band < dest.bandDb.size(); ++band)
+			dest.bandDb[band] = slot.bandDb[band].load (std::memory_order_relaxed);
+		dest.shortTermLufs = slot.shortTermLufs.load (std::memory_order_relaxed);
+
+		std::atomic_thread_fence (std::memory_order_acquire);
+		if (slot.summarySequence.load (std::memory_order_relaxed) == before)
+			return true;
+	}
+
+	return false;
+}
+
+juce::String SairyneTrackBus::readName (const Slot& slot) const
+{
+	char buffer[maxNameBytes];
+
+	for (int attempt = 0; attempt < maxReadAttempts; ++attempt)
+	{
+		const auto before = slot.nameSequence.load (std::memory_order_acquire);
+		if ((before & 1) != 0)
+			continue;
+
+		int length = 0;
+		for (int i = 0; i < maxNameBytes; ++i)
+		{
+			buffer[i] = slot.name[(size_t) i].load (std::memory_order_relaxed);
+			if (buffer[i] != 0 && length == i)
+				++length;
+		}
+
+		std::atomic_thread_fence (std::memory_order_acquire);
+		if (slot.nameSequence.load (std::memory_order_relaxed) == before)
+			return juce::String::fromUTF8 (buffer, length);
+	}
+
+	return {};
+}
+
+void SairyneTrackBus::getActiveTracks (std::vector<Track>& dest, int excludeSlot) const
+{
+	dest.clear();
+	const auto now = juce::Time::getMillisecondCounter();
+
+	for (int i = 0; i < maxTracks; ++i)
+	{
+		const auto& slot = slots[(size_t) i];
+
+		if (i == excludeSlot || ! slot.inUse.load (std::memory_order_acquire) || slot.isMaster.load (std::memory_order_relaxed))
+			continue;
+
+		const auto published = slot.lastPublishMs.load (std::memory_order_relaxed);
+		if (published == 0 || now - published > staleAfterMs)
+			continue;
+
+		Track track;
+		track.slot = i;
+
+		if (! readSummary (slot, track.summary))
+			continue;
+
+		track.name = readName (slot);
+		if (track.name.isEmpty())
+			track.name = "Track " + juce::String (i + 1);
+
+		dest.push_back (std::move (track));
+	}
+}
+
+void SairyneTrackBus::findConflicts (const std::vector<Track>& tracks, std::vector<Conflict>& dest, int maxConflicts)
+{
+	dest.clear();
+
+	std::vector<float> loudestBand (tracks.size());
+	for (size_t i = 0; i < tracks.size(); ++i)
+		loudestBand[i] = SpectralBands::getLoudestBand (tracks[i].summary.bandDb.data());
+
+	for (size_t a = 0; a < tracks.size(); ++a)
+	{
+		for (size_t b = a + 1; b < tracks.size(); ++b)
+		{
+			Conflict conflict;
+			conflict.trackA = (int) a;
+			conflict.trackB = (int) b;
+			conflict.score = SpectralBands::scoreMasking (tracks[a].summary.bandDb.data(), loudestBand[a],
+			                                              tracks[b].summary.bandDb.data(), loudestBand[b], conflict.bands);
+
+			if (! conflict.bands.empty())
+				dest.push_back (std::move (conflict));
+		}
+	}
+
+	std::sort (dest.begin(), dest.end(), [] (const Conflict& x, const Conflict& y) { return x.score > y.score; });
+
+	if ((int) dest.size() > maxConflicts)
+		dest.resize ((size_t) juce::jmax (0, maxConflicts));
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "SpectralBands.h"
+
+// Lock-free table of per-track spectral summaries shared by all plugin instances in the
+// process (owned by SairyneServices).
+//
+// Each instance claims one slot. Its analysis work publishes a small summary (1/3-octave
+// band levels + short-term loudness) a few times per second; the instance on the master
+// bus reads every other slot to detect cross-track masking. Slots are seqlocks over
+// relaxed atomics: the single writer never waits, readers retry on a torn read.
+class SairyneTrackBus
+{
+public:
+    static constexpr int maxTracks = 128;
+    static constexpr int maxNameBytes = 64;
+    static constexpr juce::uint32 staleAfterMs = 2000;   // not updated: stopped / bypassed
+
+    struct Summary
+    {
+        std::array<float, SpectralBands::numBands> bandDb {};
+        float shortTermLufs = SpectralBands::silenceDb;
+    };
+
+    struct Track
+    {
+        int slot = -1;
+        juce::String name;
+        Summary summary;
+    };
+
+    struct Conflict
+    {
+        int trackA = 0, trackB = 0;                  // indices into the tracks passed in
+        float score = 0.0f;
+        std::vector<std::pair<int, float>> bands;    // (band, severity), strongest first
+    };
+
+    SairyneTrackBus();
+
+    // Message thread. -1 when every slot is taken (the instance just doesn't take part).
+    int claimSlot();
+    void releaseSlot (int slot);
+
+    void setTrackName (int slot, const juce::String& name);
+    void setMaster (int slot, bool isMaster);
+
+    // Analysis thread of the slot's owner only. Never blocks.
+    void publish (int slot, const Summary& summary) noexcept;
+
+    // Any non-audio thread: fresh, non-master tracks other than excludeSlot.
+    void getActiveTracks (std::vector<Track>& dest, int excludeSlot) const;
+
+    static void findConflicts (const std::vector<Track>& tracks, std::vector<Conflict>& dest, int maxConflicts);
+
+private:
+    struct Slot
+    {
+        std::atomic<bool> inUse { false };
+        std::atomic<bool> isMaster { false };
+        std::atomic<juce::uint32> lastPublishMs { 0 };
+
+        std::atomic<juce::uint32> summarySequence { 0 };
+        std::array<std::atomic<float>, SpectralBands::numBands> bandDb;
+        std::atomic<float> shortTermLufs { SpectralBands::silenceDb };
+
+        std::atomic<juce::uint32> nameSequence { 0 };
+        std::array<std::atomic<char>, maxNameBytes> name;
+    };
+
+    bool readSummary (const Slot& slot, Summary& dest) const noexcept;
+    juce::String readName (const Slot& slot) const;
+
+    std::array<Slot, maxTracks> slots;
+    juce::CriticalSection nameWriteLock;    // names can be set from more than one thread
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneTrackBus)
+};
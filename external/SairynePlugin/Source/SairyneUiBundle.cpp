@@ -0,0 +1,123 @@
+#include "SairyneUiBundle.h"
+#include "SairyneLog.h"
+
+// Projucer's JuceHeader.h includes BinaryData.h, the CMake one doesn't; a target without
+// binary resources has none, and the WebView then loads the hosted UI
+#if JUCE_TARGET_HAS_BINARY_DATA
+ #include "BinaryData.h"
+#endif
+
+namespace
+{
+	// Vite emits assets/<name>-<hash>.<ext> with an 8 character base64url hash (which may
+	// itself contain '-'); the bytes behind such a name never change
+	bool isContentHashed (const juce::String& path)
+	{
+		constexpr int hashLength = 8;
+
+		if (! path.startsWith ("assets/"))
+			return false;
+
+		const auto stem = path.fromLastOccurrenceOf ("/", false, false).upToLastOccurrenceOf (".", false, false);
+		return stem.length() > hashLength + 1 && stem[stem.length() - hashLength - 1] == '-';
+	}
+}
+
+SairyneUiBundle::SairyneUiBundle()
+{
+   #if JUCE_TARGET_HAS_BINARY_DATA
+	zipData = BinaryData::getNamedResource (resourceName, zipSize);
+   #endif
+
+	if (! isAvailable())
+		SAIRYNE_LOG_DEBUG("UI bundle: not embedded in this build, using the hosted UI");
+}
+
+SairyneUiBundle::~SairyneUiBundle() = default;
+
+std::optional<juce::WebBrowserComponent::Resource> SairyneUiBundle::getResource (const juce::String& url)
+{
+	if (! isAvailable())
+		return std::nullopt;
+
+	if (zip == nullptr)
+	{
+		// Only reads the zip's central directory; entries are inflated on request
+		zip = std::make_unique<juce::ZipFile> (new juce::MemoryInputStream (zipData, (size_t) zipSize, false), true);
+		SAIRYNE_LOG_INFO("UI bundle: " + juce::String(zip->getNumEntries()) + " files, " + juce::String(zipSize / 1024) + " KB compressed");
+	}
+
+	auto path = juce::URL::removeEscapeChars (url.upToFirstOccurrenceOf ("?", false, false)
+	                                             .upToFirstOccurrenceOf ("#", false, false))
+	                .trimCharactersAtStart ("/");
+
+	if (path.isEmpty())
+		path = entryPage;
+
+	if (const auto cached = cache.find (path); cached != cache.end())
+		return juce::WebBrowserComponent::Resource { cached->second, getMimeType (path) };
+
+	const int index = zip->getIndexOfFileName (path);
+	if (index < 0)
+	{
+		SAIRYNE_LOG_WARN("UI bundle: no such file: " + path);
+		return std::nullopt;
+	}
+
+	std::unique_ptr<juce::InputStream> stream (zip->createStreamForEntry (index));
+	if (stream == nullptr)
+	{
+		SAIRYNE_LOG_ERROR("UI bundle: could not open " + path);
+		return std::nullopt;
+	}
+
+	std::vector<std::byte> data ((size_t) zip->getEntry (index)->uncompressedSize);
+	size_t numRead = 0;
+
+	while (numRead < data.size())
+	{
+		const int chunk = stream->read (data.data() + numRead, (int) juce::jmin (data.size() - numRead, (size_t) 1 << 20));
+		if (chunk <= 0)
+			break;
+		numRead += (size_t) chunk;
+	}
+
+	if (numRead != data.size())
+	{
+		SAIRYNE_LOG_ERROR("UI bundle: truncated entry " + path);
+		return std::nullopt;
+	}
+
+	if (isContentHashed (path) && data.size() <= maxCachedEntryBytes && cachedBytes + data.size() <= maxCachedBytes)
+	{
+		cache.emplace (path, data);
+		cachedBytes += data.size();
+	}
+
+	return juce::WebBrowserComponent::Resource { std::move (data), getMimeType (path) };
+}
+
+juce::String SairyneUiBundle::getMimeType (const juce::String& path)
+{
+	const auto extension = path.fromLastOccurrenceOf (".", false, false).toLowerCase();
+
+	if (extension == "html" || extension == "htm")   return "text/html";
+	if (extension == "js" || extension == "mjs")     return "text/javascript";
+	if (extension == "css")                          return "text/css";
+	if (extension == "json" || extension == "map")   return "application/json";
+	if (extension == "svg")                          return "image/svg+xml";
+	if (extension == "png")                          return "image/png";
+	if (extension == "jpg" || extension == "jpeg")   return "image/jpeg";
+	if (extension == "gif")                          return "image/gif";
+	if (extension == "webp")                         return "image/webp";
+	if (extension == "ico")                          return "image/x-icon";
+	if (extension == "woff")                         return "font/woff";
+	if (extension == "woff2")                        return "font/woff2";
+	if (extension == "ttf")                          return "font/ttf";
+	if (extension == "wasm")                         return "application/wasm";
+	if (extension == "mp3")                          return "audio/mpeg";
+	if (extension == "wav")                          return "audio/wav";
+	if (extension == "txt")                          return "text/plain";
+
+	return "application/octet-stream";
+}
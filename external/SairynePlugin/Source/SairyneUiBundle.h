@@ -0,0 +1,43 @@
+#pragma once
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// The built web UI (`npm run build:plugin-ui`: Vite's dist/ as SairyneUi.zip, added to the
+// plugin's binary data) served to the WebView through its resource provider, so the editor
+// opens without the network. Entries are only inflated when the page asks for them.
+// Files Vite names with a content hash can never change, so small ones stay inflated for
+// the life of the process; large ones are inflated per request and never kept resident.
+// Shared per process (juce::SharedResourcePointer, held by every processor so the cache
+// survives between editors). Message thread.
+class SairyneUiBundle
+{
+public:
+    static constexpr const char* resourceName = "SairyneUi_zip";
+    static constexpr const char* entryPage = "embed-chat.html";
+    static constexpr size_t maxCachedBytes = 16 * 1024 * 1024;
+    static constexpr size_t maxCachedEntryBytes = 2 * 1024 * 1024;
+
+    SairyneUiBundle();
+    ~SairyneUiBundle();
+
+    // False when the binary was built without the UI zip (the WebView loads the hosted UI)
+    bool isAvailable() const noexcept { return zipData != nullptr && zipSize > 0; }
+
+    // path as given by the resource provider ("/assets/index-3f9a1c2e.js?x")
+    std::optional<juce::WebBrowserComponent::Resource> getResource (const juce::String& path);
+
+    static juce::String getMimeType (const juce::String& path);
+
+private:
+    const char* zipData = nullptr;
+    int zipSize = 0;
+    std::unique_ptr<juce::ZipFile> zip;
+
+    std::map<juce::String, std::vector<std::byte>> cache;
+    size_t cachedBytes = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneUiBundle)
+};
@@ -0,0 +1,70 @@
+#include "SairyneWebView.h"
+#include "SairyneLog.h"
+
+SairyneWebViewCache::~SairyneWebViewCache()
+{
+	// Every holder keeps the cache alive, so by now no view is on screen
+	jassert (numInUse == 0);
+}
+
+std::unique_ptr<SairyneWebView> SairyneWebViewCache::take (const Factory& create)
+{
+	JUCE_ASSERT_MESSAGE_THREAD
+	++numInUse;
+
+	if (parked != nullptr)
+	{
+		SAIRYNE_LOG_DEBUG("WebView cache: reusing parked view");
+		return std::move (parked);
+	}
+
+	return create();
+}
+
+void SairyneWebViewCache::park (std::unique_ptr<SairyneWebView> view)
+{
+	JUCE_ASSERT_MESSAGE_THREAD
+	--numInUse;
+
+	if (view != nullptr)
+		parked = std::move (view);
+}
+
+void SairyneWebViewCache::prewarm (const Factory& create)
+{
+	JUCE_ASSERT_MESSAGE_THREAD
+
+	if (parked != nullptr || numInUse > 0)
+		return;
+
+	SAIRYNE_LOG_DEBUG("WebView cache: pre-warming");
+	parked = create();
+}
+
+//==============================================================================
+SairyneWebViewHolder::SairyneWebViewHolder (std::unique_ptr<SairyneWebView> v)
+	: view (std::move (v))
+{
+	jassert (view != nullptr);
+	setName (view->getName());
+	view->addComponentListener (this);
+	addAndMakeVisible (*view);
+}
+
+SairyneWebViewHolder::~SairyneWebViewHolder()
+{
+	view->removeComponentListener (this);
+	removeChildComponent (view.get());
+	view->attachTo (nullptr, 0.0);
+	cache->park (std::move (view));
+}
+
+void SairyneWebViewHolder::resized()
+{
+	view->setBounds (getLocalBounds());
+}
+
+void SairyneWebViewHolder::componentNameChanged (juce::Component&)
+{
+	setName (view->getName());
+}
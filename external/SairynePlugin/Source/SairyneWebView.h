@@ -0,0 +1,70 @@
+#pragma once
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+
+// 1 = create the editor's WebView once per process and re-parent it into each editor,
+// so reopening skips creating the browser and loading the page. Costs one idle browser
+// process (tens of MB) for as long as any instance is alive, hence off by default.
+#ifndef SAIRYNE_PERSISTENT_WEBVIEW
+ #define SAIRYNE_PERSISTENT_WEBVIEW 0
+#endif
+
+class SairyneAudioProcessor;
+
+// The editor's WebView. Not tied to one processor: attachTo() binds it to the instance
+// whose editor shows it (nullptr unbinds, e.g. while parked in SairyneWebViewCache).
+class SairyneWebView : public juce::WebBrowserComponent
+{
+public:
+    using juce::WebBrowserComponent::WebBrowserComponent;
+
+    // openStartedMs (Time::getMillisecondCounterHiRes) is when the editor asked for it,
+    // for the open-to-interactive measurement
+    virtual void attachTo (SairyneAudioProcessor* processor, double openStartedMs) = 0;
+};
+
+// Keeps one WebView alive between editors (SAIRYNE_PERSISTENT_WEBVIEW).
+// Shared per process (juce::SharedResourcePointer). Message thread only.
+class SairyneWebViewCache
+{
+public:
+    using Factory = std::function<std::unique_ptr<SairyneWebView>()>;
+
+    SairyneWebViewCache() = default;
+    ~SairyneWebViewCache();
+
+    // The parked view if there is one, otherwise a new one
+    std::unique_ptr<SairyneWebView> take (const Factory& create);
+    // Keeps the view for the next editor (replacing an older parked one)
+    void park (std::unique_ptr<SairyneWebView> view);
+    // Creates and parks a view ahead of the first editor, unless one already exists
+    void prewarm (const Factory& create);
+
+private:
+    std::unique_ptr<SairyneWebView> parked;
+    int numInUse = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneWebViewCache)
+};
+
+// What the editor owns instead of the browser: shows a cached SairyneWebView as its only
+// child and gives it back to the cache when the editor closes. Mirrors the browser's name,
+// which the editor watches for the sairyne://expanded= marker.
+class SairyneWebViewHolder : public juce::Component,
+                             private juce::ComponentListener
+{
+public:
+    explicit SairyneWebViewHolder (std::unique_ptr<SairyneWebView> view);
+    ~SairyneWebViewHolder() override;
+
+    void resized() override;
+
+private:
+    void componentNameChanged (juce::Component&) override;
+
+    juce::SharedResourcePointer<SairyneWebViewCache> cache;
+    std::unique_ptr<SairyneWebView> view;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SairyneWebViewHolder)
+};
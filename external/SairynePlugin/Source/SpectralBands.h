@@ -0,0 +1,81 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// 1/3-octave band layout and the masking heuristic shared by the offline stem analyzer
+// and the live cross-track bus, so both report the same bands and the same scores.
+// Band levels are mean-square power in dBFS (bands of a signal add up to its RMS).
+struct SpectralBands
+{
+    static constexpr int numBands = 31;            // 20 Hz .. 20 kHz
+    static constexpr float silenceDb = -100.0f;
+
+    // ISO 266 base-2 centres: band 17 is 1 kHz
+    static float getCentreHz (int band) noexcept
+    {
+        return 1000.0f * std::pow (2.0f, (float) (band - 17) / 3.0f);
+    }
+
+    // -1 outside 20 Hz .. 20 kHz
+    static int getBandIndex (double hz) noexcept
+    {
+        if (hz <= 0.0)
+            return -1;
+
+        const int band = (int) std::floor (17.0 + 3.0 * std::log2 (hz / 1000.0) + 0.5);
+        return band >= 0 && band < numBands ? band : -1;
+    }
+
+    static float powerToDb (double power) noexcept
+    {
+        return power > 1.0e-10 ? (float) (10.0 * std::log10 (power)) : silenceDb;
+    }
+
+    static float getLoudestBand (const float* bandDb) noexcept
+    {
+        float loudest = silenceDb;
+        for (int band = 0; band < numBands; ++band)
+            loudest = juce::jmax (loudest, bandDb[band]);
+        return loudest;
+    }
+
+    // A source "occupies" a band within occupancyRangeDb of its own loudest band; two
+    // occupants closer than maskingRangeDb to each other fight over it. Fills
+    // (band, severity 0..1) strongest first and returns the summed severity.
+    static float scoreMasking (const float* bandsA, float loudestA,
+                               const float* bandsB, float loudestB,
+                               std::vector<std::pair<int, float>>& conflicts)
+    {
+        constexpr float occupancyRangeDb = 12.0f;
+        constexpr float maskingRangeDb = 6.0f;
+        constexpr float bandFloorDb = -70.0f;
+
+        auto occupancy = [] (float level, float loudest)
+        {
+            return level < bandFloorDb ? 0.0f : juce::jmax (0.0f, 1.0f - (loudest - level) / occupancyRangeDb);
+        };
+
+        conflicts.clear();
+        float score = 0.0f;
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            const float weight = juce::jmin (occupancy (bandsA[band], loudestA), occupancy (bandsB[band], loudestB));
+            const float distance = std::abs (bandsA[band] - bandsB[band]);
+
+            if (weight <= 0.0f || distance >= maskingRangeDb)
+                continue;
+
+            const float severity = weight * (1.0f - distance / maskingRangeDb);
+            conflicts.emplace_back (band, severity);
+            score += severity;
+        }
+
+        std::sort (conflicts.begin(), conflicts.end(),
+                   [] (const auto& x, const auto& y) { return x.second > y.second; });
+        return score;
+    }
+};
@@ -0,0 +1,176 @@
+#include "StemAnalysisRunner.h"
+#include "SairyneLog.h"
+
+namespace
+{
+	constexpr int progressIntervalMs = 200;
+	constexpr int coresLeftForHost = 2;
+}
+
+StemAnalysisRunner::StemAnalysisRunner (juce::WebBrowserComponent& b)
+	: juce::Thread ("Sairyne Stem Analysis"), browser (b)
+{
+}
+
+StemAnalysisRunner::~StemAnalysisRunner()
+{
+	stopTimer();
+	cancelPendingUpdate();
+
+	// Workers poll threadShouldExit() between read blocks, so this returns quickly
+	stopThread (10000);
+}
+
+void StemAnalysisRunner::handleAnalyzeRequest (const juce::var& payload)
+{
+	if (isBusy())
+	{
+		emitError ("Analysis already in progress");
+		return;
+	}
+
+	juce::Array<juce::File> requested;
+
+	if (const auto* obj = payload.getDynamicObject())
+	{
+		if (const auto* paths = obj->getProperty("files").getArray())
+		{
+			for (const auto& path : *paths)
+				if (juce::File::isAbsolutePath (path.toString()))
+					requested.add (juce::File (path.toString()));
+		}
+		else if (obj->hasProperty("folder"))
+		{
+			const auto folder = obj->getProperty("folder").toString();
+			if (juce::File::isAbsolutePath (folder))
+				requested = StemAnalyzer::findAudioFiles (juce::File (folder));
+		}
+	}
+
+	if (! requested.isEmpty())
+	{
+		start (requested);
+		return;
+	}
+
+	// Nothing usable from the page (a sandboxed page can't see native paths) - ask the user
+	chooser = std::make_unique<juce::FileChooser> ("Choose stems or a folder of stems", juce::File(), "*.wav;*.aif;*.aiff;*.flac;*.ogg;*.mp3");
+
+	const auto flags = juce::FileBrowserComponent::openMode
+	                 | juce::FileBrowserComponent::canSelectFiles
+	                 | juce::FileBrowserComponent::canSelectDirectories
+	                 | juce::FileBrowserComponent::canSelectMultipleItems;
+
+	chooser->launchAsync (flags, [this] (const juce::FileChooser& fc)
+	{
+		juce::Array<juce::File> chosen;
+		for (const auto& file : fc.getResults())
+		{
+			if (file.isDirectory())
+				chosen.addArray (StemAnalyzer::findAudioFiles (file));
+			else
+				chosen.add (file);
+		}
+
+		chooser.reset();
+
+		if (chosen.isEmpty())
+			emitError ("No audio files selected");
+		else
+			start (chosen);
+	});
+}
+
+void StemAnalysisRunner::handleCancel()
+{
+	signalThreadShouldExit();
+}
+
+void StemAnalysisRunner::start (const juce::Array<juce::File>& toAnalyse)
+{
+	// Make sure a finished run has fully exited before the thread is reused
+	stopThread (1000);
+
+	files = toAnalyse;
+	progress = 0.0f;
+	lastEmittedProgress = -1.0f;
+
+	SAIRYNE_LOG_INFO("StemAnalysisRunner: analysing " + juce::String(files.size()) + " files");
+
+	// This thread also runs jobs while it waits for the pool
+	startThread (juce::Thread::Priority::low);
+	startTimer (progressIntervalMs);
+	timerCallback();
+}
+
+void StemAnalysisRunner::run()
+{
+	StemAnalyzer::Options options;
+	options.numThreads = juce::jmax (1, juce::SystemStats::getNumCpus() - coresLeftForHost);
+	options.priority = juce::Thread::Priority::low;
+
+	StemAnalyzer analyser (options);
+
+	const auto report = analyser.analyse (files,
+		[this] (float p) { progress.store (p, std::memory_order_relaxed); },
+		[this] { return threadShouldExit(); });
+
+	SAIRYNE_LOG_INFO("StemAnalysisRunner: " + juce::String((int) report.stems.size()) + " stems, "
+		+ juce::String(report.audioSeconds, 1) + " s of audio in " + juce::String(report.wallSeconds, 2) + " s on "
+		+ juce::String(report.numThreads) + " threads (" + juce::String(report.numSegments) + " segments, "
+		+ juce::String((juce::int64) report.stolenJobs) + " stolen)" + (report.cancelled ? " - cancelled" : ""));
+
+	{
+		const juce::ScopedLock lock (resultLock);
+		result = report.toVar();
+	}
+
+	triggerAsyncUpdate();
+}
+
+void StemAnalysisRunner::timerCallback()
+{
+	const float current = progress.load (std::memory_order_relaxed);
+	if (current == lastEmittedProgress)
+		return;
+
+	lastEmittedProgress = current;
+
+	auto* obj = new juce::DynamicObject();
+	obj->setProperty("progress", juce::roundToInt (current * 100.0f));
+	obj->setProperty("stage", "analyzing");
+	browser.emitEventIfBrowserIsVisible ("stemAnalysisProgress", juce::var (obj));
+}
+
+void StemAnalysisRunner::handleAsyncUpdate()
+{
+	stopTimer();
+
+	juce::var report;
+	{
+		const juce::ScopedLock lock (resultLock);
+		std::swap (report, result);
+	}
+
+	if (! report.isVoid())
+		deliverToPage ("stemAnalysisResult", report);
+}
+
+void StemAnalysisRunner::emitError (const juce::String& message)
+{
+	SAIRYNE_LOG_WARN("StemAnalysisRunner: " + message);
+
+	auto* obj = new juce::DynamicObject();
+	obj->setProperty("message", message);
+	deliverToPage ("stemAnalysisError", juce::var (obj));
+}
+
+void StemAnalysisRunner::deliverToPage (const char* eventName, const juce::var& payload)
+{
+	// Same message the wrapper forwards for the JUCE event, but through its __sairyneDeliver,
+	// which reaches a hidden or parked page too
+	juce::MemoryOutputStream script;
+	script << "window.__sairyneDeliver && window.__sairyneDeliver({\"type\":\"juce_stem_analysis\",\"event\":\""
+	       << eventName << "\",\"payload\":" << juce::JSON::toString (payload, true) << "});";
+	browser.evaluateJavascript (script.toUTF8());
+}
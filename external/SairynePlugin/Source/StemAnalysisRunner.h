@@ -0,0 +1,49 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include "StemAnalyzer.h"
+
+// Runs a StemAnalyzer job for the WebView ("Analyzing your channels...").
+//
+// Requests arrive on the message thread; the analysis itself runs on a background thread
+// (which fans out to the StemAnalyzer's worker pool), so the editor stays responsive.
+// Progress is polled and emitted a few times per second (dropped while the editor is hidden);
+// the final report is handed back to the message thread through an AsyncUpdater and, like
+// errors, always delivered, so a job that ends while the editor is hidden or parked still
+// completes the page's flow. Destroying the runner cancels the job.
+// Inside a DAW the host's audio threads come first: the pool leaves cores free and runs
+// at low priority (the CLI keeps one normal-priority worker per core).
+class StemAnalysisRunner : private juce::Thread,
+                           private juce::Timer,
+                           private juce::AsyncUpdater
+{
+public:
+    explicit StemAnalysisRunner (juce::WebBrowserComponent& browser);
+    ~StemAnalysisRunner() override;
+
+    // Page -> native: { files: [paths] }, { folder: path }, or {} to let the user pick
+    void handleAnalyzeRequest (const juce::var& payload);
+    void handleCancel();
+
+    bool isBusy() const { return isThreadRunning() || chooser != nullptr; }
+
+private:
+    void start (const juce::Array<juce::File>& files);
+    void run() override;
+    void timerCallback() override;
+    void handleAsyncUpdate() override;
+    void emitError (const juce::String& message);
+    void deliverToPage (const char* eventName, const juce::var& payload);
+
+    juce::WebBrowserComponent& browser;
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    juce::Array<juce::File> files;              // set before the thread starts
+    std::atomic<float> progress { 0.0f };
+    float lastEmittedProgress = -1.0f;
+
+    juce::CriticalSection resultLock;
+    juce::var result;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StemAnalysisRunner)
+};
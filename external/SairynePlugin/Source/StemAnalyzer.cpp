@@ -0,0 +1,426 @@
+#include "StemAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+namespace
+{
+	constexpr int readBlockSize = 8192;
+
+	// Gating blocks are 4 x 100 ms: 300 ms of pre-roll in front of a segment completes the
+	// block that ends 100 ms into it, so merged segments gate exactly like a single pass.
+	constexpr int prerollSubBlocks = 3;
+
+	int getSubBlockLength (double sampleRate)
+	{
+		// Same grid as LoudnessMeter::prepare()
+		return juce::jmax (1, juce::roundToInt (sampleRate * 0.1));
+	}
+}
+
+struct StemAnalyzer::SegmentResult
+{
+	LoudnessMeter meter;
+	float peak = 0.0f;
+	double sumSquares = 0.0;
+	int64_t numSamples = 0;
+	std::array<double, numBands> bandPower {};
+	int64_t numFrames = 0;
+};
+
+struct StemAnalyzer::Stem
+{
+	juce::File file;
+	std::unique_ptr<juce::AudioFormatReader> mappedReader; // shared by all segments; null if not mappable
+	double sampleRate = 0.0;
+	int numChannels = 0;
+	int64_t length = 0;
+	int64_t segmentLength = 0;
+	std::vector<SegmentResult> segments;
+	StemReport report;
+};
+
+StemAnalyzer::StemAnalyzer()
+	: StemAnalyzer (Options{})
+{
+}
+
+StemAnalyzer::StemAnalyzer (Options o)
+	: options (o)
+{
+	formatManager.registerBasicFormats();
+}
+
+juce::Array<juce::File> StemAnalyzer::findAudioFiles (const juce::File& folder)
+{
+	juce::AudioFormatManager manager;
+	manager.registerBasicFormats();
+
+	auto files = folder.findChildFiles (juce::File::findFiles, false, manager.getWildcardForAllFormats());
+	files.sort();
+	return files;
+}
+
+StemAnalyzer::Report StemAnalyzer::analyse (const juce::Array<juce::File>& files,
+                                            ProgressCallback progress,
+                                            std::function<bool()> shouldCancel)
+{
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+	Report report;
+	std::vector<std::unique_ptr<Stem>> stems;
+	int64_t totalSamples = 0;
+
+	samplesDone = 0;
+
+	for (const auto& file : files)
+	{
+		auto stem = std::make_unique<Stem>();
+		stem->file = file;
+		stem->report.name = file.getFileNameWithoutExtension();
+		stem->report.path = file.getFullPathName();
+
+		std::unique_ptr<juce::AudioFormatReader> reader;
+
+		if (auto* format = formatManager.findFormatForFileExtension (file.getFileExtension()))
+		{
+			std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+
+			if (mapped != nullptr && mapped->mapEntireFile())
+				reader = std::move (mapped);
+		}
+
+		stem->report.memoryMapped = reader != nullptr;
+
+		// Compressed formats: each segment opens its own streaming reader instead
+		if (reader == nullptr)
+			reader.reset (formatManager.createReaderFor (file));
+
+		if (reader == nullptr || reader->sampleRate <= 0.0 || reader->lengthInSamples <= 0)
+		{
+			stem->report.error = reader == nullptr ? "Unsupported or unreadable audio file" : "Empty audio file";
+			stems.push_back (std::move (stem));
+			continue;
+		}
+
+		stem->sampleRate = reader->sampleRate;
+		stem->numChannels = (int) reader->numChannels;
+		stem->length = reader->lengthInSamples;
+
+		const int subBlock = getSubBlockLength (stem->sampleRate);
+		stem->segmentLength = (int64_t) subBlock * juce::jmax (1, juce::roundToInt (options.segmentSeconds * 10.0));
+		stem->segments.resize ((size_t) ((stem->length + stem->segmentLength - 1) / stem->segmentLength));
+
+		stem->report.sampleRate = stem->sampleRate;
+		stem->report.numChannels = stem->numChannels;
+		stem->report.lengthSeconds = (double) stem->length / stem->sampleRate;
+
+		if (stem->report.memoryMapped)
+			stem->mappedReader = std::move (reader);
+
+		totalSamples += stem->length;
+		report.audioSeconds += stem->report.lengthSeconds;
+		report.numSegments += (int) stem->segments.size();
+		stems.push_back (std::move (stem));
+	}
+
+	{
+		WorkStealingPool pool (options.numThreads, options.priority);
+
+		// Segment-major order: the first jobs touch every stem, so one long stem can't
+		// end up as the tail that a single worker finishes alone.
+		size_t maxSegments = 0;
+		for (const auto& stem : stems)
+			maxSegments = juce::jmax (maxSegments, stem->segments.size());
+
+		for (size_t segment = 0; segment < maxSegments; ++segment)
+		{
+			for (auto& stem : stems)
+			{
+				if (segment >= stem->segments.size())
+					continue;
+
+				pool.submit ([this, &target = *stem, segment, totalSamples, &progress, &shouldCancel]
+				{
+					analyseSegment (target, (int) segment, shouldCancel);
+
+					if (progress && totalSamples > 0)
+						progress ((float) ((double) samplesDone.load (std::memory_order_relaxed) / (double) totalSamples));
+				});
+			}
+		}
+
+		pool.waitForAll();
+		report.numThreads = pool.getNumThreads();
+		report.stolenJobs = pool.getStats().stolen.load();
+	}
+
+	report.cancelled = shouldCancel && shouldCancel();
+
+	for (auto& stem : stems)
+	{
+		mergeSegments (*stem);
+		report.stems.push_back (std::move (stem->report));
+	}
+
+	stems.clear(); // unmaps the files
+
+	if (! report.cancelled)
+		findMasking (report);
+
+	report.wallSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+	return report;
+}
+
+void StemAnalyzer::analyseSegment (Stem& stem, int segmentIndex, const std::function<bool()>& shouldCancel)
+{
+	auto& result = stem.segments[(size_t) segmentIndex];
+	const int64_t start = (int64_t) segmentIndex * stem.segmentLength;
+	const int64_t end = juce::jmin (stem.length, start + stem.segmentLength);
+	const int64_t meterStart = juce::jmax ((int64_t) 0, start - (int64_t) prerollSubBlocks * getSubBlockLength (stem.sampleRate));
+
+	// Memory-mapped readers have no stream position, so segments can share one
+	std::unique_ptr<juce::AudioFormatReader> ownReader;
+	auto* reader = stem.mappedReader.get();
+
+	if (reader == nullptr)
+	{
+		ownReader.reset (formatManager.createReaderFor (stem.file));
+		reader = ownReader.get();
+
+		if (reader == nullptr)
+			return;
+	}
+
+	const int numChannels = juce::jmin (LoudnessMeter::maxChannels, stem.numChannels);
+	result.meter.prepare (stem.sampleRate, numChannels);
+
+	// Welch: Hann frames with 50% overlap on the channel average, power summed per band
+	const int fftSize = 1 << options.fftOrder;
+	const int hopSize = fftSize / 2;
+	juce::dsp::FFT fft (options.fftOrder);
+	juce::dsp::WindowingFunction<float> window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false);
+	std::vector<float> fftData ((size_t) fftSize * 2);
+	std::vector<float> pending ((size_t) (fftSize + readBlockSize));
+	int pendingCount = 0;
+
+	double windowPower = 0.0;
+	{
+		std::vector<float> ones ((size_t) fftSize, 1.0f);
+		window.multiplyWithWindowingTable (ones.data(), (size_t) fftSize);
+		for (auto w : ones)
+			windowPower += (double) w * (double) w;
+	}
+
+	// One-sided power scaled so the bands add up to the signal's mean square
+	const double powerScale = 2.0 / ((double) fftSize * windowPower);
+
+	std::vector<int> binToBand ((size_t) hopSize + 1, -1);
+	for (int bin = 1; bin <= hopSize; ++bin)
+		binToBand[(size_t) bin] = SpectralBands::getBandIndex ((double) bin * stem.sampleRate / (double) fftSize);
+
+	juce::AudioBuffer<float> buffer (numChannels, readBlockSize);
+	const float channelGain = 1.0f / (float) numChannels;
+
+	for (int64_t pos = meterStart; pos < end;)
+	{
+		if (shouldCancel && shouldCancel())
+			return;
+
+		const int numSamples = (int) juce::jmin ((int64_t) readBlockSize, end - pos);
+		reader->read (&buffer, 0, numSamples, pos, true, true);
+
+		result.meter.process (buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+		// The pre-roll only warms up the meter; everything else belongs to the next segment back
+		const int skip = (int) juce::jlimit ((int64_t) 0, (int64_t) numSamples, start - pos);
+		const int count = numSamples - skip;
+
+		if (count > 0)
+		{
+			float* mono = pending.data() + pendingCount;
+			juce::FloatVectorOperations::clear (mono, count);
+
+			for (int ch = 0; ch < numChannels; ++ch)
+			{
+				const float* in = buffer.getReadPointer (ch, skip);
+				const auto range = juce::FloatVectorOperations::findMinAndMax (in, count);
+				result.peak = juce::jmax (result.peak, -range.getStart(), range.getEnd());
+
+				double sum = 0.0;
+				for (int i = 0; i < count; ++i)
+					sum += (double) in[i] * (double) in[i];
+				result.sumSquares += sum;
+
+				juce::FloatVectorOperations::addWithMultiply (mono, in, channelGain, count);
+			}
+
+			result.numSamples += count;
+			pendingCount += count;
+
+			while (pendingCount >= fftSize)
+			{
+				std::copy (pending.begin(), pending.begin() + fftSize, fftData.begin());
+				window.multiplyWithWindowingTable (fftData.data(), (size_t) fftSize);
+				fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+				for (int bin = 1; bin <= hopSize; ++bin)
+					if (const int band = binToBand[(size_t) bin]; band >= 0)
+						result.bandPower[(size_t) band] += (double) fftData[(size_t) bin] * (double) fftData[(size_t) bin] * powerScale;
+
+				++result.numFrames;
+				std::copy (pending.begin() + hopSize, pending.begin() + pendingCount, pending.begin());
+				pendingCount -= hopSize;
+			}
+		}
+
+		pos += numSamples;
+	}
+
+	samplesDone.fetch_add (end - start, std::memory_order_relaxed);
+}
+
+void StemAnalyzer::mergeSegments (Stem& stem)
+{
+	auto& report = stem.report;
+	report.bandDb.fill (silenceDb);
+
+	if (stem.segments.empty())
+		return;
+
+	auto& merged = stem.segments.front();
+	std::array<double, numBands> bandPower = merged.bandPower;
+	int64_t numFrames = merged.numFrames;
+	int64_t numSamples = merged.numSamples;
+	double sumSquares = merged.sumSquares;
+	float peak = merged.peak;
+
+	for (size_t i = 1; i < stem.segments.size(); ++i)
+	{
+		const auto& segment = stem.segments[i];
+		merged.meter.mergeGatingHistogram (segment.meter);
+
+		for (size_t band = 0; band < bandPower.size(); ++band)
+			bandPower[band] += segment.bandPower[band];
+
+		numFrames += segment.numFrames;
+		numSamples += segment.numSamples;
+		sumSquares += segment.sumSquares;
+		peak = juce::jmax (peak, segment.peak);
+	}
+
+	report.integratedLufs = merged.meter.getIntegratedLufs();
+	report.peakDb = juce::Decibels::gainToDecibels (peak, silenceDb);
+
+	const int numChannels = juce::jmin (LoudnessMeter::maxChannels, stem.numChannels);
+	if (numSamples > 0)
+		report.rmsDb = SpectralBands::powerToDb (sumSquares / ((double) numSamples * (double) numChannels));
+
+	if (numFrames > 0)
+		for (size_t band = 0; band < bandPower.size(); ++band)
+			report.bandDb[band] = SpectralBands::powerToDb (bandPower[band] / (double) numFrames);
+
+	stem.segments.clear();
+	stem.mappedReader.reset();
+}
+
+void StemAnalyzer::findMasking (Report& report) const
+{
+	const auto& stems = report.stems;
+	std::vector<float> loudestBand (stems.size());
+
+	for (size_t i = 0; i < stems.size(); ++i)
+		loudestBand[i] = SpectralBands::getLoudestBand (stems[i].bandDb.data());
+
+	for (size_t a = 0; a < stems.size(); ++a)
+	{
+		if (stems[a].error.isNotEmpty())
+			continue;
+
+		for (size_t b = a + 1; b < stems.size(); ++b)
+		{
+			if (stems[b].error.isNotEmpty())
+				continue;
+
+			MaskingPair pair;
+			pair.stemA = (int) a;
+			pair.stemB = (int) b;
+			pair.score = SpectralBands::scoreMasking (stems[a].bandDb.data(), loudestBand[a],
+			                                          stems[b].bandDb.data(), loudestBand[b], pair.bands);
+
+			if (! pair.bands.empty())
+				report.masking.push_back (std::move (pair));
+		}
+	}
+
+	std::sort (report.masking.begin(), report.masking.end(),
+	           [] (const MaskingPair& x, const MaskingPair& y) { return x.score > y.score; });
+
+	if ((int) report.masking.size() > options.maxMaskingPairs)
+		report.masking.resize ((size_t) juce::jmax (0, options.maxMaskingPairs));
+}
+
+juce::var StemAnalyzer::Report::toVar() const
+{
+	juce::Array<juce::var> bandCentres;
+	for (int band = 0; band < numBands; ++band)
+		bandCentres.add (SpectralBands::getCentreHz (band));
+
+	juce::Array<juce::var> stemList;
+	for (const auto& stem : stems)
+	{
+		juce::Array<juce::var> bandList;
+		for (auto level : stem.bandDb)
+			bandList.add (level);
+
+		auto* obj = new juce::DynamicObject();
+		obj->setProperty("name", stem.name);
+		obj->setProperty("path", stem.path);
+		obj->setProperty("sampleRate", stem.sampleRate);
+		obj->setProperty("numChannels", stem.numChannels);
+		obj->setProperty("lengthSeconds", stem.lengthSeconds);
+		obj->setProperty("memoryMapped", stem.memoryMapped);
+		obj->setProperty("integratedLufs", stem.integratedLufs);
+		obj->setProperty("peakDb", stem.peakDb);
+		obj->setProperty("rmsDb", stem.rmsDb);
+		obj->setProperty("bandsDb", bandList);
+		if (stem.error.isNotEmpty())
+			obj->setProperty("error", stem.error);
+		stemList.add (juce::var (obj));
+	}
+
+	juce::Array<juce::var> maskingList;
+	for (const auto& pair : masking)
+	{
+		juce::Array<juce::var> bandList;
+		for (const auto& band : pair.bands)
+		{
+			auto* entry = new juce::DynamicObject();
+			entry->setProperty("band", band.first);
+			entry->setProperty("hz", SpectralBands::getCentreHz (band.first));
+			entry->setProperty("severity", band.second);
+			bandList.add (juce::var (entry));
+		}
+
+		auto* obj = new juce::DynamicObject();
+		obj->setProperty("a", pair.stemA);
+		obj->setProperty("b", pair.stemB);
+		obj->setProperty("score", pair.score);
+		obj->setProperty("bands", bandList);
+		maskingList.add (juce::var (obj));
+	}
+
+	auto* result = new juce::DynamicObject();
+	result->setProperty("numThreads", numThreads);
+	result->setProperty("numSegments", numSegments);
+	result->setProperty("stolenJobs", (juce::int64) stolenJobs);
+	result->setProperty("wallSeconds", wallSeconds);
+	result->setProperty("audioSeconds", audioSeconds);
+	result->setProperty("realtimeFactor", wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0);
+	result->setProperty("cancelled", cancelled);
+	result->setProperty("bandCentresHz", bandCentres);
+	result->setProperty("stems", stemList);
+	result->setProperty("masking", maskingList);
+	return juce::var (result);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "SpectralBands.h"
+
+// Offline analysis of exported stems / bounced channels (no audio thread involved).
+//
+// Every file is opened once through a memory-mapped reader when the format supports it
+// (WAV/AIFF), so workers read straight out of the page cache without seeking a shared
+// stream. Each stem is cut into fixed-length segments aligned to the 100 ms loudness
+// grid; segments are analysed in parallel on a WorkStealingPool and merged per stem
+// (loudness via the gating histogram, spectrum via averaged Welch power). A pairwise
+// masking pass then compares the stems' 1/3-octave spectra.
+//
+// Used by the plugin (StemAnalysisRunner) and by the headless SairyneAnalyzerCli.
+class StemAnalyzer
+{
+public:
+    static constexpr int numBands = SpectralBands::numBands;
+    static constexpr float silenceDb = SpectralBands::silenceDb;
+
+    struct Options
+    {
+        int numThreads = 0;                        // 0 = one per CPU core
+        juce::Thread::Priority priority = juce::Thread::Priority::normal;
+        double segmentSeconds = 10.0;              // work unit size
+        int fftOrder = 12;                         // 4096-point Welch frames, 50% overlap
+        int maxMaskingPairs = 100;
+    };
+
+    struct StemReport
+    {
+        juce::String name;
+        juce::String path;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        double lengthSeconds = 0.0;
+        bool memoryMapped = false;
+
+        float integratedLufs = silenceDb;
+        float peakDb = silenceDb;
+        float rmsDb = silenceDb;
+        std::array<float, numBands> bandDb {};     // mean band power, dBFS
+
+        juce::String error;                        // non-empty if the file could not be read
+    };
+
+    struct MaskingPair
+    {
+        int stemA = 0, stemB = 0;
+        float score = 0.0f;                        // sum of per-band severities
+        std::vector<std::pair<int, float>> bands;  // (band, severity 0..1), strongest first
+    };
+
+    struct Report
+    {
+        std::vector<StemReport> stems;
+        std::vector<MaskingPair> masking;
+
+        int numThreads = 0;
+        int numSegments = 0;
+        int64_t stolenJobs = 0;
+        double wallSeconds = 0.0;
+        double audioSeconds = 0.0;
+        bool cancelled = false;
+
+        juce::var toVar() const;
+    };
+
+    // Called from worker threads with 0..1; must be thread-safe and cheap.
+    using ProgressCallback = std::function<void (float)>;
+
+    StemAnalyzer();
+    explicit StemAnalyzer (Options options);
+
+    Report analyse (const juce::Array<juce::File>& files,
+                    ProgressCallback progress = {},
+                    std::function<bool()> shouldCancel = {});
+
+    // Audio files directly inside a folder (not recursive), sorted by name.
+    static juce::Array<juce::File> findAudioFiles (const juce::File& folder);
+
+private:
+    struct Stem;
+    struct SegmentResult;
+
+    void analyseSegment (Stem& stem, int segmentIndex, const std::function<bool()>& shouldCancel);
+    static void mergeSegments (Stem& stem);
+    void findMasking (Report& report) const;
+
+    Options options;
+    juce::AudioFormatManager formatManager;
+    std::atomic<int64_t> samplesDone { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StemAnalyzer)
+};
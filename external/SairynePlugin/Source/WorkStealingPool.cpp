@@ -0,0 +1,168 @@
+#include "WorkStealingPool.h"
+
+namespace
+{
+	// Lets submit()/waitForAll() called from inside a job find the worker's own deque
+	thread_local const WorkStealingPool* currentPool = nullptr;
+	thread_local int currentWorkerIndex = -1;
+
+	uint32_t nextRandom (uint32_t& state) noexcept
+	{
+		// xorshift32 - only used to pick steal victims
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+}
+
+class WorkStealingPool::Worker : public juce::Thread
+{
+public:
+	Worker (WorkStealingPool& p, int i)
+		: juce::Thread ("Sairyne Worker " + juce::String (i)), pool (p), index (i)
+	{
+	}
+
+	void run() override
+	{
+		currentPool = &pool;
+		currentWorkerIndex = index;
+		uint32_t rng = 0x9e3779b9u * (uint32_t) (index + 1);
+
+		while (! threadShouldExit())
+			if (! pool.tryRunOne (index, rng))
+				pool.workAvailable.wait (5);
+
+		currentPool = nullptr;
+		currentWorkerIndex = -1;
+	}
+
+private:
+	WorkStealingPool& pool;
+	const int index;
+};
+
+WorkStealingPool::WorkStealingPool (int numThreads, juce::Thread::Priority priority)
+{
+	if (numThreads <= 0)
+		numThreads = juce::SystemStats::getNumCpus();
+
+	numThreads = juce::jlimit (1, 256, numThreads);
+
+	for (int i = 0; i < numThreads; ++i)
+		queues.push_back (std::make_unique<Queue>());
+
+	for (int i = 0; i < numThreads; ++i)
+	{
+		workers.push_back (std::make_unique<Worker> (*this, i));
+		workers.back()->startThread (priority);
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	// Jobs still queued here are dropped - callers waitForAll() first
+	jassert (pending.load() == 0);
+
+	for (auto& worker : workers)
+		worker->signalThreadShouldExit();
+
+	for (auto& worker : workers)
+	{
+		workAvailable.signal();
+		worker->stopThread (10000);
+	}
+}
+
+void WorkStealingPool::submit (Job job)
+{
+	const int self = currentPool == this ? currentWorkerIndex : -1;
+	const int target = self >= 0 ? self : (int) (nextQueue.fetch_add (1, std::memory_order_relaxed) % (uint32_t) queues.size());
+
+	pending.fetch_add (1, std::memory_order_acq_rel);
+	allDone.reset();
+
+	{
+		auto& queue = *queues[(size_t) target];
+		const juce::ScopedLock lock (queue.lock);
+		queue.jobs.push_back (std::move (job));
+	}
+
+	workAvailable.signal();
+}
+
+void WorkStealingPool::waitForAll()
+{
+	const int self = currentPool == this ? currentWorkerIndex : -1;
+	uint32_t rng = 0x85ebca6bu ^ (uint32_t) juce::Time::getHighResolutionTicks();
+
+	// Help out instead of sleeping; only block once there is nothing left to take
+	while (pending.load (std::memory_order_acquire) > 0)
+		if (! tryRunOne (self, rng))
+			allDone.wait (1);
+}
+
+bool WorkStealingPool::tryRunOne (int selfIndex, uint32_t& rng)
+{
+	Job job;
+
+	if (! (selfIndex >= 0 && popLocal (selfIndex, job)) && ! steal (selfIndex, rng, job))
+		return false;
+
+	// More work may be queued behind this one; wake another sleeper
+	if (pending.load (std::memory_order_relaxed) > 1)
+		workAvailable.signal();
+
+	job();
+	stats.executed.fetch_add (1, std::memory_order_relaxed);
+
+	if (pending.fetch_sub (1, std::memory_order_acq_rel) == 1)
+		allDone.signal();
+
+	return true;
+}
+
+bool WorkStealingPool::popLocal (int index, Job& job)
+{
+	auto& queue = *queues[(size_t) index];
+	const juce::ScopedLock lock (queue.lock);
+
+	if (queue.jobs.empty())
+		return false;
+
+	job = std::move (queue.jobs.back());
+	queue.jobs.pop_back();
+	return true;
+}
+
+bool WorkStealingPool::steal (int thiefIndex, uint32_t& rng, Job& job)
+{
+	const int numQueues = (int) queues.size();
+	const int start = (int) (nextRandom (rng) % (uint32_t) numQueues);
+
+	for (int i = 0; i < numQueues; ++i)
+	{
+		const int victim = (start + i) % numQueues;
+		if (victim == thiefIndex)
+			continue;
+
+		auto& queue = *queues[(size_t) victim];
+		const juce::ScopedTryLock lock (queue.lock);
+
+		// Contended - someone else is on it, try the next victim
+		if (! lock.isLocked() || queue.jobs.empty())
+			continue;
+
+		// Oldest job: the owner is working from the other end
+		job = std::move (queue.jobs.front());
+		queue.jobs.pop_front();
+
+		if (thiefIndex >= 0)
+			stats.stolen.fetch_add (1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Fixed-size work-stealing thread pool for batch (non-real-time) jobs.
+//
+// Each worker owns a deque: it pushes and pops its own jobs at the back (cache-warm,
+// depth-first) and, when empty, steals from the front of a random victim's deque.
+// submit() from outside the pool distributes round-robin. waitForAll() lets the
+// calling thread help run jobs instead of just blocking.
+class WorkStealingPool
+{
+public:
+    using Job = std::function<void()>;
+
+    // numThreads 0 = one per CPU core
+    explicit WorkStealingPool (int numThreads = 0, juce::Thread::Priority priority = juce::Thread::Priority::normal);
+    ~WorkStealingPool();
+
+    void submit (Job job);
+    void waitForAll();
+
+    int getNumThreads() const noexcept { return (int) workers.size(); }
+
+    struct Stats
+    {
+        std::atomic<int64_t> executed { 0 };
+        std::atomic<int64_t> stolen { 0 };
+    };
+
+    const Stats& getStats() const noexcept { return stats; }
+
+private:
+    struct Queue
+    {
+        juce::CriticalSection lock;
+        std::deque<Job> jobs;
+    };
+
+    class Worker;
+
+    bool tryRunOne (int selfIndex, uint32_t& rng);
+    bool popLocal (int index, Job& job);
+    bool steal (int thiefIndex, uint32_t& rng, Job& job);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> pending { 0 };
+    std::atomic<uint32_t> nextQueue { 0 };
+    juce::WaitableEvent workAvailable;
+    juce::WaitableEvent allDone { true };
+    Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkStealingPool)
+};
@@ -0,0 +1,151 @@
+/*
+    processBlock realtime-safety test (target SairyneTests, see CMakeLists.txt here; run with
+    ctest).
+
+    Built with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1, so every heap allocation made inside
+    processBlock's SairyneRealtimeScope is counted, as are locks and logging that reach
+    SAIRYNE_ASSERT_NOT_REALTIME or the logger. A host-like audio thread drives processBlock
+    at several sample rates and block sizes, first with no editor, then with one attached
+    (the analysis engine switches to its full-rate spectrum and the message thread reads
+    snapshots the way AnalysisFrameStreamer does). Any counted violation fails the test.
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/RealtimeContext.h"
+
+#if ! SAIRYNE_DETECT_REALTIME_ALLOCATIONS
+ #error "Build with SAIRYNE_DETECT_REALTIME_ALLOCATIONS=1, or allocations on the audio thread go unnoticed"
+#endif
+
+namespace
+{
+	constexpr int numChannels = 2;
+	constexpr int phaseMs = 250;
+	constexpr int messageThreadPollMs = 16;
+
+	struct ViolationCounts
+	{
+		int allocations = SairyneRealtimeScope::getAllocationViolationCount();
+		int blockingCalls = SairyneRealtimeScope::getBlockingCallViolationCount();
+
+		int allocationsSince() const     { return SairyneRealtimeScope::getAllocationViolationCount() - allocations; }
+		int blockingCallsSince() const   { return SairyneRealtimeScope::getBlockingCallViolationCount() - blockingCalls; }
+	};
+
+	// Calls processBlock the way a host's audio thread does: back-to-back callbacks of the
+	// prepared size, now and then a shorter one
+	class HostAudioThread : public juce::Thread
+	{
+	public:
+		HostAudioThread (SairyneAudioProcessor& p, int maximumBlockSize)
+			: juce::Thread ("Sairyne Test Audio"), processor (p), buffer (numChannels, maximumBlockSize)
+		{
+			juce::Random random (1);
+
+			for (int ch = 0; ch < numChannels; ++ch)
+				for (int i = 0; i < maximumBlockSize; ++i)
+					buffer.setSample (ch, i, random.nextFloat() * 0.5f - 0.25f);
+		}
+
+		~HostAudioThread() override
+		{
+			stopThread (2000);
+		}
+
+		int getNumBlocksProcessed() const noexcept { return blocksProcessed.load(); }
+
+		void run() override
+		{
+			juce::MidiBuffer midi;
+
+			for (int block = 0; ! threadShouldExit(); ++block)
+			{
+				const int numSamples = block % 7 == 6 ? buffer.getNumSamples() / 2 + 1 : buffer.getNumSamples();
+				juce::AudioBuffer<float> view (buffer.getArrayOfWritePointers(), numChannels, numSamples);
+				processor.processBlock (view, midi);
+				++blocksProcessed;
+
+				// Leave the analysis thread some room, as the gaps between host callbacks do
+				if (block % 8 == 7)
+					juce::Thread::sleep (1);
+			}
+		}
+
+	private:
+		SairyneAudioProcessor& processor;
+		juce::AudioBuffer<float> buffer;
+		std::atomic<int> blocksProcessed { 0 };
+	};
+}
+
+class ProcessBlockRealtimeTest : public juce::UnitTest
+{
+public:
+	ProcessBlockRealtimeTest() : juce::UnitTest ("processBlock realtime safety", "Sairyne") {}
+
+	void runTest() override
+	{
+		beginTest ("Allocations inside a realtime scope are counted");
+		{
+			const ViolationCounts before;
+			{
+				const SairyneRealtimeScope realtimeScope;
+				// Called directly: the compiler may elide a new-expression, but not this
+				::operator delete (::operator new (64));
+			}
+			expectEquals (before.allocationsSince(), 1);
+		}
+
+		for (const double sampleRate : { 44100.0, 48000.0, 96000.0 })
+		{
+			for (const int blockSize : { 32, 64, 256, 1024 })
+			{
+				beginTest (juce::String (sampleRate, 0) + " Hz, " + juce::String (blockSize) + " samples");
+				runConfiguration (sampleRate, blockSize);
+			}
+		}
+	}
+
+private:
+	void runConfiguration (double sampleRate, int blockSize)
+	{
+		SairyneAudioProcessor processor;
+		processor.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+		processor.prepareToPlay (sampleRate, blockSize);
+
+		const ViolationCounts before;
+		uint32_t lastSequence = 0;
+
+		{
+			HostAudioThread audioThread (processor, blockSize);
+			audioThread.startThread (juce::Thread::Priority::highest);
+
+			juce::Thread::sleep (phaseMs);
+
+			processor.editorAttached();
+			SairyneAnalysisEngine::Snapshot snapshot;
+
+			for (int elapsedMs = 0; elapsedMs < phaseMs; elapsedMs += messageThreadPollMs)
+			{
+				if (processor.getAnalysisEngine().getLatestSnapshot (snapshot, lastSequence))
+					lastSequence = snapshot.sequence;
+
+				juce::Thread::sleep (messageThreadPollMs);
+			}
+
+			processor.editorDetached();
+			audioThread.stopThread (2000);
+
+			expect (audioThread.getNumBlocksProcessed() > 0, "processBlock was never called");
+		}
+
+		expect (lastSequence > 0, "the analysis thread never published a snapshot");
+		expectEquals (before.allocationsSince(), 0, "heap allocations inside processBlock");
+		expectEquals (before.blockingCallsSince(), 0, "locks or logging inside processBlock");
+
+		processor.releaseResources();
+	}
+};
+
+static ProcessBlockRealtimeTest processBlockRealtimeTest;
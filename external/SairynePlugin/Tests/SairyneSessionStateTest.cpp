@@ -0,0 +1,220 @@
+/*
+    SairyneSessionState chunk codec test (target SairyneTests, see CMakeLists.txt here; run
+    with ctest).
+
+    Round-trips raw and zlib sections, checks that an unchanged state hands the host back
+    the same bytes, and feeds restoreFrom hand-built chunks: every truncation, offsets and
+    sizes pointing past the payload, bad magic/version, and a section in an encoding this
+    build doesn't know, which must come back out byte for byte.
+*/
+
+#include <JuceHeader.h>
+#include "../Source/SairyneSessionState.h"
+
+namespace
+{
+	struct TestSection
+	{
+		juce::String name;
+		uint8_t encoding = 0;
+		juce::MemoryBlock payload;
+		uint32_t rawBytes = (uint32_t) payload.getSize();
+	};
+
+	// Writes a chunk the way SairyneSessionState does (see its header); the offset and stored
+	// size of section `corruptIndex` can be overridden
+	juce::MemoryBlock makeChunk (const std::vector<TestSection>& sectionsToWrite,
+								 int corruptIndex = -1, uint32_t corruptOffset = 0, uint32_t corruptStoredBytes = 0,
+								 int magic = 0x4e595253, int version = 1)
+	{
+		juce::MemoryBlock chunk;
+		juce::MemoryOutputStream out (chunk, false);
+
+		out.writeInt (magic);
+		out.writeShort ((short) version);
+		out.writeShort ((short) sectionsToWrite.size());
+
+		uint32_t offset = 0;
+		for (size_t i = 0; i < sectionsToWrite.size(); ++i)
+		{
+			const auto& section = sectionsToWrite[i];
+			const auto nameBytes = section.name.getNumBytesAsUTF8();
+			const bool corrupt = (int) i == corruptIndex;
+
+			out.writeShort ((short) nameBytes);
+			out.write (section.name.toRawUTF8(), nameBytes);
+			out.writeByte ((char) section.encoding);
+			out.writeInt ((int) section.rawBytes);
+			out.writeInt ((int) (corrupt ? corruptOffset : offset));
+			out.writeInt ((int) (corrupt ? corruptStoredBytes : (uint32_t) section.payload.getSize()));
+			offset += (uint32_t) section.payload.getSize();
+		}
+
+		for (const auto& section : sectionsToWrite)
+			out.write (section.payload.getData(), section.payload.getSize());
+
+		out.flush();
+		return chunk;
+	}
+
+	juce::MemoryBlock utf8 (const juce::String& text)
+	{
+		return { text.toRawUTF8(), text.getNumBytesAsUTF8() };
+	}
+
+	juce::String makeLongValue (juce::Random& random)
+	{
+		juce::String value;
+
+		for (int i = 0; i < 400; ++i)
+			value << "{\"role\":\"user\",\"text\":\"message " << random.nextInt (1000) << "\"},";
+
+		return value;
+	}
+}
+
+class SairyneSessionStateTest : public juce::UnitTest
+{
+public:
+	SairyneSessionStateTest() : juce::UnitTest ("Session state codec", "Sairyne") {}
+
+	void runTest() override
+	{
+		auto random = getRandom();
+
+		beginTest ("Round trip");
+		{
+			const auto longValue = makeLongValue (random);
+
+			SairyneSessionState state;
+			expect (state.setValue ("selected_project", "Demo"));
+			expect (state.setValue ("chat_state_v1", longValue));
+			expect (! state.setValue ("selected_project", "Demo"), "re-saving the same value dirtied the state");
+
+			juce::MemoryBlock chunk;
+			state.writeTo (chunk);
+			expectLessThan ((int) chunk.getSize(), (int) longValue.getNumBytesAsUTF8(), "the long section was not compressed");
+
+			SairyneSessionState restored;
+			expect (restored.restoreFrom (chunk.getData(), (int) chunk.getSize()));
+			expectEquals (restored.getNumSections(), 2);
+			expectEquals (restored.getValue ("selected_project"), juce::String ("Demo"));
+			expectEquals (restored.getValue ("chat_state_v1"), longValue);
+			expectEquals (restored.getValue ("missing"), juce::String());
+
+			juce::MemoryBlock again;
+			restored.writeTo (again);
+			expect (again == chunk, "an unchanged state wrote different bytes");
+
+			expect (restored.removeValue ("selected_project"));
+			expect (restored.setValue ("chat_state_v1", ""), "an empty value must remove the section");
+			expectEquals (restored.getNumSections(), 0);
+		}
+
+		beginTest ("Truncated chunks are rejected");
+		{
+			SairyneSessionState state;
+			state.setValue ("selected_project", "Demo");
+			state.setValue ("chat_state_v1", makeLongValue (random));
+
+			juce::MemoryBlock chunk;
+			state.writeTo (chunk);
+
+			for (size_t size = 0; size < chunk.getSize(); ++size)
+			{
+				SairyneSessionState restored;
+				restored.setValue ("stale", "value");
+
+				if (restored.restoreFrom (chunk.getData(), (int) size))
+				{
+					expect (false, "accepted a chunk truncated to " + juce::String ((int) size) + " bytes");
+					break;
+				}
+
+				expectEquals (restored.getNumSections(), 0);
+			}
+
+			SairyneSessionState restored;
+			expect (! restored.restoreFrom (nullptr, 0));
+		}
+
+		beginTest ("Offsets and sizes past the payload are rejected");
+		{
+			const std::vector<TestSection> sections { { "a", 0, utf8 ("first") }, { "b", 0, utf8 ("second") } };
+			const uint32_t payloadSize = 5 + 6;
+
+			const auto good = makeChunk (sections);
+			SairyneSessionState state;
+			expect (state.restoreFrom (good.getData(), (int) good.getSize()));
+			expectEquals (state.getValue ("b"), juce::String ("second"));
+
+			const struct { uint32_t offset, storedBytes; } corruptions[] {
+				{ payloadSize + 1, 0 },
+				{ 0, payloadSize + 1 },
+				{ 6, payloadSize },
+				{ 0xffffffffu, 1 },
+				{ 1, 0xffffffffu }
+			};
+
+			for (const auto& corruption : corruptions)
+			{
+				const auto chunk = makeChunk (sections, 1, corruption.offset, corruption.storedBytes);
+				expect (! state.restoreFrom (chunk.getData(), (int) chunk.getSize()),
+						"accepted offset " + juce::String ((juce::int64) corruption.offset)
+							+ ", size " + juce::String ((juce::int64) corruption.storedBytes));
+				expectEquals (state.getNumSections(), 0);
+			}
+		}
+
+		beginTest ("Bad magic and version are rejected");
+		{
+			const std::vector<TestSection> sections { { "a", 0, utf8 ("first") } };
+			SairyneSessionState state;
+
+			const auto badMagic = makeChunk (sections, -1, 0, 0, 0x12345678);
+			expect (! state.restoreFrom (badMagic.getData(), (int) badMagic.getSize()));
+
+			const auto badVersion = makeChunk (sections, -1, 0, 0, 0x4e595253, 2);
+			expect (! state.restoreFrom (badVersion.getData(), (int) badVersion.getSize()));
+		}
+
+		beginTest ("Sections in an unknown encoding are written back unchanged");
+		{
+			juce::MemoryBlock opaquePayload;
+			for (int i = 0; i < 64; ++i)
+				opaquePayload.append (&i, 1);
+
+			const std::vector<TestSection> sections {
+				{ "chat_state_v1", 0, utf8 ("chat") },
+				{ "from_newer_build", 7, opaquePayload, 12345 }
+			};
+
+			const auto chunk = makeChunk (sections);
+			SairyneSessionState state;
+			expect (state.restoreFrom (chunk.getData(), (int) chunk.getSize()));
+			expectEquals (state.getNumSections(), 2);
+			expectEquals (state.getValue ("from_newer_build"), juce::String(), "an opaque section must read as empty");
+			expect (! state.getNames().contains ("from_newer_build"));
+
+			juce::MemoryBlock unchanged;
+			state.writeTo (unchanged);
+			expect (unchanged == chunk, "an unchanged state dropped or rewrote the opaque section");
+
+			// Rewriting another section re-encodes the chunk; the opaque one must survive that
+			expect (state.setValue ("chat_state_v1", "edited"));
+			juce::MemoryBlock edited;
+			state.writeTo (edited);
+
+			const auto expected = makeChunk ({ { "chat_state_v1", 0, utf8 ("edited") },
+											   { "from_newer_build", 7, opaquePayload, 12345 } });
+			expect (edited == expected, "the opaque section was not written back byte for byte");
+
+			// Overwriting it with a value this build can read replaces it
+			expect (state.setValue ("from_newer_build", "replaced"));
+			expectEquals (state.getValue ("from_newer_build"), juce::String ("replaced"));
+			expect (state.getNames().contains ("from_newer_build"));
+		}
+	}
+};
+
+static SairyneSessionStateTest sairyneSessionStateTest;
@@ -0,0 +1,59 @@
+/*
+    Runner for the juce::UnitTests in this folder (category "Sairyne").
+
+        SairyneTests                  every test
+        SairyneTests "<test name>"    one test, as ctest runs them
+
+    Exits non-zero if any expectation failed or the named test doesn't exist.
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+
+namespace
+{
+	// The plugin's logger replaces juce::Logger while a processor exists; report to the console
+	class ConsoleTestRunner : public juce::UnitTestRunner
+	{
+		void logMessage (const juce::String& message) override
+		{
+			std::cout << message << std::endl;
+		}
+	};
+}
+
+int main (int argc, char* argv[])
+{
+	const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	ConsoleTestRunner runner;
+	runner.setAssertOnFailure (false);
+
+	if (argc > 1)
+	{
+		const auto name = juce::String::fromUTF8 (argv[1]);
+		juce::Array<juce::UnitTest*> selected;
+
+		for (auto* test : juce::UnitTest::getAllTests())
+			if (test->getCategory() == "Sairyne" && test->getName() == name)
+				selected.add (test);
+
+		if (selected.isEmpty())
+		{
+			std::cerr << "No test named \"" << name << "\"" << std::endl;
+			return 1;
+		}
+
+		runner.runTests (selected);
+	}
+	else
+	{
+		runner.runTestsInCategory ("Sairyne");
+	}
+
+	int failures = 0;
+	for (int i = 0; i < runner.getNumResults(); ++i)
+		failures += runner.getResult (i)->failures;
+
+	return failures == 0 ? 0 : 1;
+}
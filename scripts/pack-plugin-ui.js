@@ -0,0 +1,93 @@
+// Packs dist/ into external/SairynePlugin/Resources/SairyneUi.zip for the plugin's BinaryData.
+// Plain Node (zlib), so the build works wherever Node does - no `zip` CLI needed on Windows.
+// Output is deterministic: sorted entries, fixed timestamps, no source maps.
+import { readdirSync, readFileSync, mkdirSync, writeFileSync } from 'node:fs';
+import { join, relative, sep } from 'node:path';
+import { deflateRawSync } from 'node:zlib';
+
+const sourceDir = 'dist';
+const outputFile = 'external/SairynePlugin/Resources/SairyneUi.zip';
+
+const crcTable = new Uint32Array(256).map((_, n) => {
+  let c = n;
+  for (let k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+  return c >>> 0;
+});
+
+function crc32(data) {
+  let crc = 0xffffffff;
+  for (let i = 0; i < data.length; i++) crc = crcTable[(crc ^ data[i]) & 0xff] ^ (crc >>> 8);
+  return (crc ^ 0xffffffff) >>> 0;
+}
+
+function listFiles(dir) {
+  return readdirSync(dir, { withFileTypes: true }).flatMap((entry) => {
+    const path = join(dir, entry.name);
+    return entry.isDirectory() ? listFiles(path) : [path];
+  });
+}
+
+const dosTime = 0;
+const dosDate = (0 << 9) | (1 << 5) | 1; // 1980-01-01
+const utf8NamesFlag = 0x0800;
+
+const localParts = [];
+const centralParts = [];
+let offset = 0;
+
+const files = listFiles(sourceDir)
+  .filter((path) => !path.endsWith('.map'))
+  .map((path) => ({ path, name: relative(sourceDir, path).split(sep).join('/') }))
+  .sort((a, b) => (a.name < b.name ? -1 : 1));
+
+for (const { path, name } of files) {
+  const data = readFileSync(path);
+  const deflated = deflateRawSync(data, { level: 9 });
+  const compressed = deflated.length < data.length;
+  const body = compressed ? deflated : data;
+  const nameBytes = Buffer.from(name, 'utf8');
+  const crc = crc32(data);
+
+  const local = Buffer.alloc(30);
+  local.writeUInt32LE(0x04034b50, 0);
+  local.writeUInt16LE(20, 4);
+  local.writeUInt16LE(utf8NamesFlag, 6);
+  local.writeUInt16LE(compressed ? 8 : 0, 8);
+  local.writeUInt16LE(dosTime, 10);
+  local.writeUInt16LE(dosDate, 12);
+  local.writeUInt32LE(crc, 14);
+  local.writeUInt32LE(body.length, 18);
+  local.writeUInt32LE(data.length, 22);
+  local.writeUInt16LE(nameBytes.length, 26);
+  local.writeUInt16LE(0, 28);
+
+  const central = Buffer.alloc(46);
+  central.writeUInt32LE(0x02014b50, 0);
+  central.writeUInt16LE(20, 4);
+  central.writeUInt16LE(20, 6);
+  central.writeUInt16LE(utf8NamesFlag, 8);
+  central.writeUInt16LE(compressed ? 8 : 0, 10);
+  central.writeUInt16LE(dosTime, 12);
+  central.writeUInt16LE(dosDate, 14);
+  central.writeUInt32LE(crc, 16);
+  central.writeUInt32LE(body.length, 20);
+  central.writeUInt32LE(data.length, 24);
+  central.writeUInt16LE(nameBytes.length, 28);
+  central.writeUInt32LE(offset, 42);
+
+  localParts.push(local, nameBytes, body);
+  centralParts.push(central, nameBytes);
+  offset += local.length + nameBytes.length + body.length;
+}
+
+const centralSize = centralParts.reduce((size, part) => size + part.length, 0);
+const end = Buffer.alloc(22);
+end.writeUInt32LE(0x06054b50, 0);
+end.writeUInt16LE(files.length, 8);
+end.writeUInt16LE(files.length, 10);
+end.writeUInt32LE(centralSize, 12);
+end.writeUInt32LE(offset, 16);
+
+mkdirSync('external/SairynePlugin/Resources', { recursive: true });
+writeFileSync(outputFile, Buffer.concat([...localParts, ...centralParts, end]));
+console.log(`${outputFile}: ${files.length} files, ${offset + centralSize + end.length} bytes`);
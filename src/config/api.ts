@@ -26,8 +26,9 @@ function inferApiBase(): string {
       return '';
     }
 
-    // If opened from disk inside the plugin, prefer the hosted backend.
-    if (protocol === 'file:') {
+    // If opened from disk or from the UI bundled in the plugin binary
+    // (served by JUCE at juce://juce.backend/ or https://juce.backend/), prefer the hosted backend.
+    if (protocol === 'file:' || hostname === 'juce.backend') {
       return RENDER_API_BASE;
     }
 
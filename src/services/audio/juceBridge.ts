@@ -334,6 +334,206 @@ function tryEmitNativeEvent(eventName: string, payload: any): boolean {
   return false;
 }
 
+// ============================================
+// RPC (запрос → один ответ с тем же id)
+// ============================================
+
+const RPC_TIMEOUT_MS = 10000;
+
+// Время полного круга callJuce (отправка → доставка juce_rpc_result) копится здесь
+// и уходит в JUCE пачкой (событие rpcTimings → bridgeRpcRoundTripMicros)
+const RPC_TIMINGS_FLUSH_MS = 1000;
+const RPC_TIMINGS_MAX_BATCH = 64;
+
+interface PendingRpc {
+  resolve: (result: any) => void;
+  reject: (error: Error) => void;
+  timer: ReturnType<typeof setTimeout>;
+  sentAt: number;
+}
+
+let nextRpcId = 1;
+const pendingRpcs = new Map<number, PendingRpc>();
+
+let rpcRoundTripMicros: number[] = [];
+let rpcTimingsTimer: ReturnType<typeof setTimeout> | null = null;
+
+function flushRpcTimings(): void {
+  if (rpcTimingsTimer !== null) {
+    clearTimeout(rpcTimingsTimer);
+    rpcTimingsTimer = null;
+  }
+  if (rpcRoundTripMicros.length === 0) return;
+
+  const report = { roundTripMicros: rpcRoundTripMicros };
+  rpcRoundTripMicros = [];
+  if (!tryEmitNativeEvent('rpcTimings', report)) {
+    sendToJuceViaPostMessage('rpc_timings', report);
+  }
+}
+
+function recordRpcRoundTrip(sentAt: number): void {
+  rpcRoundTripMicros.push(Math.round((performance.now() - sentAt) * 1000));
+  if (rpcRoundTripMicros.length >= RPC_TIMINGS_MAX_BATCH) flushRpcTimings();
+  else if (rpcTimingsTimer === null) rpcTimingsTimer = setTimeout(flushRpcTimings, RPC_TIMINGS_FLUSH_MS);
+}
+
+if (typeof window !== 'undefined') {
+  // Ответы JUCE приходят через __sairyneDeliver обёртки; без обёртки (страница загружена напрямую) — в это же окно
+  if (window.parent === window && !(window as any).__sairyneDeliver) {
+    (window as any).__sairyneDeliver = (message: unknown) => window.postMessage(message, '*');
+  }
+
+  window.addEventListener('message', (event: MessageEvent) => {
+    const data = event.data;
+    if (!data || data.type !== 'juce_rpc_result') return;
+
+    const pending = pendingRpcs.get(data.id);
+    if (!pending) return;
+
+    pendingRpcs.delete(data.id);
+    clearTimeout(pending.timer);
+    if (data.error !== undefined) {
+      pending.reject(new Error(String(data.error)));
+    } else {
+      // Ошибки не считаем: 'native bridge unavailable' отвечает сама обёртка, без JUCE
+      recordRpcRoundTrip(pending.sentAt);
+      pending.resolve(data.result);
+    }
+  });
+
+  // Страницу перенесли в другой экземпляр плагина (или прогретая страница получила проект)
+  window.addEventListener('message', (event: MessageEvent) => {
+    const data = event.data;
+    if (!data || data.type !== 'juce_session') return;
+    applySessionState(Number(data.generation), data.values ?? {});
+  });
+}
+
+/**
+ * Вызвать метод JUCE: { id, method, params } → Promise с result (или error).
+ */
+export function callJuce<T = unknown>(
+  method: string,
+  params: Record<string, unknown> = {},
+  timeoutMs: number = RPC_TIMEOUT_MS
+): Promise<T> {
+  return new Promise<T>((resolve, reject) => {
+    const id = nextRpcId++;
+    const timer = setTimeout(() => {
+      pendingRpcs.delete(id);
+      reject(new Error(`JUCE rpc ${method} timed out`));
+    }, timeoutMs);
+    pendingRpcs.set(id, { resolve, reject, timer, sentAt: performance.now() });
+
+    const call = { id, method, params };
+    if (!tryEmitNativeEvent('rpc', call)) {
+      sendToJuceViaPostMessage('rpc', call);
+    }
+  });
+}
+
+/**
+ * Прочитать несколько ключей одним запросом; отсутствующих ключей в ответе нет.
+ */
+export async function storageGet(keys: string[]): Promise<Record<string, string>> {
+  const result = await callJuce<{ values?: Record<string, string> }>('storage.get', { keys });
+  return result?.values ?? {};
+}
+
+/**
+ * Сохранить несколько ключей одним запросом (пустое значение удаляет ключ).
+ * generation — проект, который показывает страница: ключи проекта из прежнего JUCE отбросит.
+ */
+export async function storageSet(entries: Record<string, string>): Promise<number> {
+  const result = await callJuce<{ saved?: number }>('storage.set', { entries, generation: projectGeneration });
+  return result?.saved ?? 0;
+}
+
+// Сохранения/загрузки за один тик уходят одним запросом
+const queuedSaves = new Map<string, string>();
+const queuedLoads = new Set<string>();
+
+// Поколение проекта из ready / juce_session (undefined, пока JUCE не ответил)
+let projectGeneration: number | undefined;
+
+/**
+ * Заменить состояние проекта на присланное JUCE (juce_session): в values все ключи
+ * проекта, пустые — у нового проекта их нет. Ключи прежнего проекта, которых нет в
+ * values, тоже очищаются; его ещё не отправленные сохранения отбрасываются.
+ */
+function applySessionState(generation: number, values: Record<string, string>): void {
+  projectGeneration = generation;
+
+  Array.from(queuedSaves.keys()).forEach((key) => {
+    if (isSessionKey(key)) queuedSaves.delete(key);
+  });
+
+  const next: Record<string, string> = { ...values };
+  const storage = (window as any).__sairyneStorage as Map<string, string> | undefined;
+  storage?.forEach((_value, key) => {
+    if (isSessionKey(key) && !(key in next)) next[key] = '';
+  });
+
+  console.log('[JUCE Bridge] 🔄 Project changed (generation', generation + '):', Object.keys(next).join(', '));
+  (window as any).onJuceInit?.(next);
+}
+
+// Неудавшиеся сохранения повторяются: после ответа на ready, затем с нарастающей задержкой
+const SAVE_RETRY_BASE_MS = 500;
+const SAVE_RETRY_MAX_MS = 10000;
+
+let initialStateReceived = false;
+let saveRetryTimer: ReturnType<typeof setTimeout> | null = null;
+let saveRetryDelayMs = SAVE_RETRY_BASE_MS;
+
+function scheduleSaveRetry(): void {
+  // До ответа на ready повторит сам обработчик рукопожатия
+  if (!initialStateReceived || saveRetryTimer !== null) return;
+  saveRetryTimer = setTimeout(() => {
+    saveRetryTimer = null;
+    flushQueuedSaves();
+  }, saveRetryDelayMs);
+  saveRetryDelayMs = Math.min(saveRetryDelayMs * 2, SAVE_RETRY_MAX_MS);
+}
+
+function flushQueuedSaves(): void {
+  if (queuedSaves.size === 0) return;
+  const entries = Object.fromEntries(queuedSaves);
+  const generation = projectGeneration;
+  queuedSaves.clear();
+  storageSet(entries)
+    .then(() => {
+      saveRetryDelayMs = SAVE_RETRY_BASE_MS;
+    })
+    .catch((e) => {
+      // JUCE ещё не поднялся (ранняя загрузка, перезагрузка страницы): ничего не теряем —
+      // возвращаем в очередь, не затирая более новые значения; ключи проекта, который
+      // страница уже не показывает, не возвращаем
+      Object.entries(entries).forEach(([key, value]) => {
+        if (queuedSaves.has(key)) return;
+        if (isSessionKey(key) && generation !== projectGeneration) return;
+        queuedSaves.set(key, value);
+      });
+      console.warn('[JUCE Bridge] ⚠️ storage.set failed, keeping', Object.keys(entries).length, 'keys for retry:', e);
+      scheduleSaveRetry();
+    });
+}
+
+function flushQueuedLoads(): void {
+  if (queuedLoads.size === 0) return;
+  const keys = Array.from(queuedLoads);
+  queuedLoads.clear();
+  storageGet(keys)
+    .then((values) => {
+      const deliver = (window as any).onJuceDataLoaded;
+      if (typeof deliver !== 'function') return;
+      // Пустое значение для отсутствующего ключа: onJuceDataLoaded снимет pending и запишет tombstone
+      keys.forEach((key) => deliver(key, values[key] ?? ''));
+    })
+    .catch((e) => console.warn('[JUCE Bridge] ⚠️ storage.get failed:', e));
+}
+
 // ============================================
 // EXPORTED FUNCTIONS
 // ============================================
@@ -453,6 +653,18 @@ export function setPluginExpanded(expanded: boolean): void {
   } catch {}
 }
 
+/**
+ * Ключи, которые JUCE хранит в проекте DAW (состояние плагина в сессии), а не в общем
+ * хранилище: состояние чата, выбранный проект и всё с префиксом sairyne_session_.
+ * Держать в согласии с SairyneAudioProcessor::isSessionKey (external/SairynePlugin/Source/PluginProcessor.cpp).
+ */
+const SESSION_KEY_PREFIX = 'sairyne_session_';
+const SESSION_KEYS = new Set<string>(['sairyne_functional_chat_state_v1', 'sairyne_selected_project']);
+
+function isSessionKey(key: string): boolean {
+  return SESSION_KEYS.has(key) || key.startsWith(SESSION_KEY_PREFIX);
+}
+
 /**
  * Сохранить данные в JUCE PropertiesFile
  * Uses postMessage only - no location.href
@@ -473,14 +685,9 @@ export function saveDataToJuce(key: string, value: string): void {
     // juce_init can race with app boot; if we wait for juceReady, saves can be stuck forever.
   }
 
-  // Preferred in plugin iframe: JUCE native event listener
-  if (tryEmitNativeEvent('saveData', { key, value })) {
-    return;
-  }
-
-  // Preferred in sandboxed iframe: postMessage to wrapper, which then performs juce://save
-  console.log('[JUCE Bridge] 📤 Preferred: postMessage save_data to wrapper');
-  sendToJuceViaPostMessage(JuceMessageType.SAVE_DATA, { key, value });
+  // Batched storage.set (native event, or postMessage to the wrapper in a sandboxed iframe)
+  if (queuedSaves.size === 0) queueMicrotask(flushQueuedSaves);
+  queuedSaves.set(key, value);
   return;
 
   // Last resort: JUCE scheme (works when NOT inside a sandboxed iframe)
@@ -508,14 +715,9 @@ export function loadDataFromJuce(key: string): void {
     // IMPORTANT (AU/WKWebView): still attempt the request immediately via postMessage.
   }
 
-  // Preferred in plugin iframe: JUCE native event listener
-  if (tryEmitNativeEvent('loadData', { key })) {
-    return;
-  }
-
-  // Preferred in sandboxed iframe: postMessage to wrapper, which then performs juce://load
-  console.log('[JUCE Bridge] 📤 Preferred: postMessage load_data to wrapper');
-  sendToJuceViaPostMessage(JuceMessageType.LOAD_DATA, { key });
+  // Batched storage.get; the reply goes to window.onJuceDataLoaded per key
+  if (queuedLoads.size === 0) queueMicrotask(flushQueuedLoads);
+  queuedLoads.add(key);
   return;
 
   // Last resort: JUCE scheme (works when NOT inside a sandboxed iframe)
@@ -568,6 +770,48 @@ export function onDataLoaded(callback: (payload: { key: string; value: string })
   };
 }
 
+// Повторы ready: 50 мс, 100 мс, ... до 2 с между попытками, ~30 с в сумме
+const READY_RETRY_BASE_MS = 50;
+const READY_RETRY_MAX_MS = 2000;
+const READY_MAX_ATTEMPTS = 20;
+const READY_ATTEMPT_TIMEOUT_MS = 3000;
+
+function hasNativeBackend(): boolean {
+  return typeof (window as any).__JUCE__?.backend?.emitEvent === 'function';
+}
+
+/**
+ * Запросить сохранённое состояние у JUCE (метод 'ready').
+ * __JUCE__ может появиться позже загрузки модуля, а обёртка фрейма до этого отвечает
+ * 'native bridge unavailable' — поэтому повторяем с нарастающей задержкой, пока не придёт ответ.
+ */
+async function requestInitialState(): Promise<Record<string, string>> {
+  let delayMs = READY_RETRY_BASE_MS;
+
+  for (let attempt = 1; ; attempt++) {
+    // Во фрейме вызов уходит в обёртку, которая сама проверяет __JUCE__
+    if (window.parent !== window || hasNativeBackend()) {
+      try {
+        const result = await callJuce<{ values?: Record<string, string>; generation?: number }>(
+          'ready',
+          {},
+          READY_ATTEMPT_TIMEOUT_MS
+        );
+        projectGeneration = result?.generation;
+        return result?.values ?? {};
+      } catch (e) {
+        if (attempt >= READY_MAX_ATTEMPTS) throw e;
+        console.log(`[JUCE Bridge] ⏳ ready attempt ${attempt} failed, retrying in ${delayMs} ms:`, e);
+      }
+    } else if (attempt >= READY_MAX_ATTEMPTS) {
+      throw new Error('window.__JUCE__ never became available');
+    }
+
+    await new Promise((resolve) => setTimeout(resolve, delayMs));
+    delayMs = Math.min(delayMs * 2, READY_RETRY_MAX_MS);
+  }
+}
+
 // ============================================
 // GLOBAL FUNCTIONS EXPOSED TO WINDOW
 // ============================================
@@ -611,6 +855,8 @@ if (typeof window !== 'undefined') {
         Object.entries(data).forEach(([key, value]) => {
           // IMPORTANT: runtime boot id must be runtime-only, never cached across host restarts.
           if (
+            // Project-scoped: localStorage is shared by every instance, so another project would read it
+            isSessionKey(key) ||
             // IMPORTANT: runtime boot id must be runtime-only, never cached across host restarts.
             key === 'sairyne_runtime_boot_id' ||
             // UI routing keys can cause sticky navigation if cached.
@@ -666,6 +912,16 @@ if (typeof window !== 'undefined') {
       console.log('[JUCE Bridge] ✅ Dispatched sairyne-init-loaded + per-key sairyne-data-loaded events');
     }
   };
+
+  // Ready handshake: JUCE answers with the saved state once; onJuceInit runs only after that answer
+  requestInitialState()
+    .then((values) => {
+      (window as any).onJuceInit(values);
+      // Сохранения, отклонённые до рукопожатия, уходят сейчас
+      initialStateReceived = true;
+      flushQueuedSaves();
+    })
+    .catch((e) => console.warn('[JUCE Bridge] ⚠️ ready handshake failed:', e));
 }
 
 // ============================================
@@ -704,6 +960,200 @@ export function onAnalysisError(callback: (error: { message: string }) => void):
   return bridge.on<{ message: string }>(JuceEventType.ANALYSIS_ERROR, callback);
 }
 
+/**
+ * Живой анализ мастер-канала (спектр, LUFS, RMS/peak, корреляция).
+ * Кадры приходят бинарно: bands — Float32Array (dB), без JSON-массивов.
+ */
+export interface AnalysisFrame {
+  seq: number;
+  sampleRate: number;
+  peakDb: number[];
+  rmsDb: number[];
+  correlation: number;
+  momentaryLufs: number;
+  shortTermLufs: number;
+  integratedLufs: number;
+  bandCount: number;
+  bands: Float32Array;
+  sent: number;
+  coalesced: number;
+  backpressured: number;
+  hidden: number;
+  resumed: number;
+}
+
+export function subscribeToAnalysisFrames(fps: number, callback: (frame: AnalysisFrame) => void): () => void {
+  const handler = (event: MessageEvent) => {
+    if (event.data && event.data.type === 'juce_analysis_frame' && event.data.frame) {
+      callback(event.data.frame as AnalysisFrame);
+    }
+  };
+  window.addEventListener('message', handler);
+  sendToJuceViaPostMessage('analysis_subscribe', { fps });
+
+  return () => {
+    window.removeEventListener('message', handler);
+    sendToJuceViaPostMessage('analysis_subscribe', { fps: 0 });
+  };
+}
+
+/**
+ * Счётчики производительности плагина (общие для всех экземпляров в процессе).
+ * Времена в микросекундах; processBlockLoadPerMille — доля бюджета блока в промилле.
+ */
+export interface DiagnosticsHistogram {
+  count: number;
+  mean: number;
+  p50: number;
+  p95: number;
+  p99: number;
+  max: number;
+}
+
+export interface Diagnostics {
+  processBlockMicros: DiagnosticsHistogram;
+  processBlockLoadPerMille: DiagnosticsHistogram;
+  blocksOverBudget: number;
+  analysisPassMicros: DiagnosticsHistogram;
+  bridgeRpcHandlerMicros: DiagnosticsHistogram;
+  bridgeRpcRoundTripMicros: DiagnosticsHistogram;
+  analysisFrameRoundTripMicros: DiagnosticsHistogram;
+  editorOpenColdMicros: DiagnosticsHistogram;
+  editorOpenWarmMicros: DiagnosticsHistogram;
+  store: {
+    getMicros: DiagnosticsHistogram;
+    setMicros: DiagnosticsHistogram;
+    flushMicros: DiagnosticsHistogram;
+    compactionMicros: DiagnosticsHistogram;
+    recordsWritten: number;
+    bytesWritten: number;
+    batchesWritten: number;
+    compactions: number;
+  };
+  instances: number;
+  analysisEngines: number;
+  realtimeAllocations: number;
+}
+
+export function subscribeToDiagnostics(intervalMs: number, callback: (diagnostics: Diagnostics) => void): () => void {
+  const handler = (event: MessageEvent) => {
+    if (event.data && event.data.type === 'juce_diagnostics' && event.data.payload) {
+      callback(event.data.payload as Diagnostics);
+    }
+  };
+  window.addEventListener('message', handler);
+  sendToJuceViaPostMessage('diagnostics_subscribe', { intervalMs });
+
+  return () => {
+    window.removeEventListener('message', handler);
+    sendToJuceViaPostMessage('diagnostics_subscribe', { intervalMs: 0 });
+  };
+}
+
+/**
+ * Офлайн-анализ стемов/каналов (нативный StemAnalyzer, все ядра).
+ * Без files/folder JUCE сам откроет диалог выбора файлов.
+ */
+export interface StemAnalysisRequest {
+  files?: string[];
+  folder?: string;
+}
+
+export interface StemReport {
+  name: string;
+  path: string;
+  sampleRate: number;
+  numChannels: number;
+  lengthSeconds: number;
+  memoryMapped: boolean;
+  integratedLufs: number;
+  peakDb: number;
+  rmsDb: number;
+  bandsDb: number[];
+  error?: string;
+}
+
+export interface StemMaskingPair {
+  a: number;
+  b: number;
+  score: number;
+  bands: { band: number; hz: number; severity: number }[];
+}
+
+export interface StemAnalysisReport {
+  numThreads: number;
+  numSegments: number;
+  stolenJobs: number;
+  wallSeconds: number;
+  audioSeconds: number;
+  realtimeFactor: number;
+  cancelled: boolean;
+  bandCentresHz: number[];
+  stems: StemReport[];
+  masking: StemMaskingPair[];
+}
+
+export interface StemAnalysisHandlers {
+  onProgress?: (payload: AnalysisProgressPayload) => void;
+  onResult?: (report: StemAnalysisReport) => void;
+  onError?: (error: { message: string }) => void;
+}
+
+export function analyzeStems(request: StemAnalysisRequest, handlers: StemAnalysisHandlers): () => void {
+  const handler = (event: MessageEvent) => {
+    if (!event.data || event.data.type !== 'juce_stem_analysis') return;
+    const { event: name, payload } = event.data;
+    if (name === 'stemAnalysisProgress') handlers.onProgress?.(payload);
+    else if (name === 'stemAnalysisResult') handlers.onResult?.(payload);
+    else if (name === 'stemAnalysisError') handlers.onError?.(payload);
+  };
+  window.addEventListener('message', handler);
+  sendToJuceViaPostMessage('analyze_stems', request);
+
+  return () => {
+    window.removeEventListener('message', handler);
+  };
+}
+
+export function cancelStemAnalysis(): void {
+  sendToJuceViaPostMessage('cancel_stem_analysis', {});
+}
+
+/**
+ * Маскировка между дорожками проекта (только в инстансе на мастер-канале).
+ * Мастер определяется по имени дорожки в хосте; role позволяет задать его вручную.
+ */
+export type TrackRole = 'master' | 'track' | 'auto';
+
+export interface CrossTrackMaskingTrack {
+  slot: number;
+  name: string;
+  shortTermLufs: number;
+}
+
+export interface CrossTrackMasking {
+  active: boolean;
+  tracks?: CrossTrackMaskingTrack[];
+  conflicts?: StemMaskingPair[];
+}
+
+export function setTrackRole(role: TrackRole): void {
+  sendToJuceViaPostMessage('set_track_role', { role });
+}
+
+export function onCrossTrackMasking(callback: (masking: CrossTrackMasking) => void): () => void {
+  const handler = (event: MessageEvent) => {
+    if (event.data && event.data.type === 'juce_cross_track_masking' && event.data.payload) {
+      callback(event.data.payload as CrossTrackMasking);
+    }
+  };
+  window.addEventListener('message', handler);
+
+  return () => {
+    window.removeEventListener('message', handler);
+  };
+}
+
 /**
  * Legacy functions for compatibility
  */